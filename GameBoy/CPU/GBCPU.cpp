@@ -25,6 +25,19 @@ GBCPU::GBCPU()
     // Initialize cycle count
     cycles = 0;
 
+    // No cartridge is loaded yet
+    rom = NULL;
+    ext_ram = NULL;
+    ext_ram_dirty = false;
+    save = NULL;
+    cart_mapper = NULL;
+
+    // Set by the GameBoy instance that owns this CPU
+    gb = NULL;
+
+    // Initialize I/O register handler table
+    initIO();
+
     // Initialize OPCODE member function table
     opcodes[0x00] = &GBCPU::OP00; opcodes[0x01] = &GBCPU::OP01; opcodes[0x02] = &GBCPU::OP02; opcodes[0x03] = &GBCPU::OP03;
     opcodes[0x04] = &GBCPU::OP04; opcodes[0x05] = &GBCPU::OP05;	opcodes[0x06] = &GBCPU::OP06; opcodes[0x07] = &GBCPU::OP07;
@@ -196,7 +209,12 @@ GBCPU::~GBCPU()
 void GBCPU::execute()
 {
     //printf("PC: $%04X OPCODE: %02X AF: 0x%02X%02X BC: 0x%02X%02X DE: 0x%02X%02X HL: 0x%02X%02X SP: 0x%04X \n", PC, MEM[PC], A, GetF(), B, C, D, E, H, L, SP);
-	(this->*(opcodes)[MEM[PC]])();
+    // Fetch the opcode through the memory map, so code in switchable ROM banks runs from the selected bank
+    // and code outside HRAM sees the bus blocked while an OAM DMA transfer is running
+    BYTE opcode = readByte(PC);
+
+	(this->*(opcodes)[opcode])();
+    cycle_count += cycles;
 }
 
 #ifdef DEBUG_GAMEBOY
@@ -216,8 +234,11 @@ void GBCPU::init()
     // Initialize internal CPU variables
     IME = false;
     halted = false;
+    halt_waited = false;
     DIV_counter = 0;
     TMA_counter = 0;
+    cycle_count = 0;
+    dma_end_cycle = 0;
     PC = 0x100;
 
     // For GB, set to this value. For others, will be different
@@ -269,6 +290,9 @@ void GBCPU::init()
     // Initialize JOYPAD to no buttons pressed to prevent resets
     MEM[JOYPAD_P1] = 0x3F;
 
+    // Map memory pages now that the cartridge type is known
+    initMemoryMap();
+
     cout << "done!" << endl;
 }
 
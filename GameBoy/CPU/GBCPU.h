@@ -6,6 +6,21 @@
 
 using namespace std;
 
+class GBCPU;
+class GameBoy;
+struct rom_image;
+struct save_file;
+struct mapper;
+
+// Handlers that reads and writes of an I/O register ($FF00 - $FF7F) go through
+typedef BYTE (*io_read_handler)(WORD addr, GBCPU & CPU);
+typedef void (*io_write_handler)(BYTE data, WORD addr, GBCPU & CPU);
+
+#define IO_REGISTERS (IO_END - IO_START + 1)
+
+// Memory is mapped in pages of 256 bytes
+#define MEMORY_PAGES (MAX_GB_MEMORY >> 8)
+
 /*
 	Class:		 GBCPU
 	Description: Software implementation of the ZILOG Z80 & INTEL 8088 Hybrid CPU, named
@@ -14,6 +29,14 @@ class GBCPU
 {
 public:
 	BYTE MEM[MAX_GB_MEMORY]; 	// CPU Memory (PRG) Currently 64K max size
+
+    GameBoy * gb;               // The emulator instance this CPU belongs to, which holds the rest of its state
+
+    rom_image * rom;            // The cartridge ROM, shared with any other instance running the same game
+    BYTE * ext_ram;             // This instance's external (switchable) RAM, in 8 Kbyte banks
+    bool ext_ram_dirty;         // External RAM was written since it was last saved
+    save_file * save;           // The .sav file behind battery-backed external RAM, NULL if it isn't saved
+    const mapper * cart_mapper; // The cartridge's memory bank controller, which maps its banks into the page tables
 	//WORD ADDR;					// CPU Address Bus  - UNUSED
 	//byte DATA;					// CPU Data Bus     - UNUSED
 
@@ -36,9 +59,12 @@ public:
     /***** Internal Variables *****/
     bool IME;                   // Interrupt Master Enable flag
     bool halted;                // Indicates that HALT has executed. Used in interrupt checks
+    bool halt_waited;           // Flag used to freeze PC for one cycle before exiting HALT
     BYTE cycles;				// The number of cycles currently counted
     unsigned short DIV_counter; // Internal DIV cycle counter to increment the DIV counter in memory
     unsigned short TMA_counter; // Internal TMA cycle counter to increment the time counter in memory
+    unsigned long long cycle_count;     // Total number of cycles executed
+    unsigned long long dma_end_cycle;   // cycle_count at which the current OAM DMA transfer ends
 
 	// Function Declarations
 	GBCPU();					// Constructor
@@ -47,9 +73,17 @@ public:
     void (GBCPU::*opcodes[256])(); 	 // Array of pointers to Opcode member functions
     void (GBCPU::*CBopcodes[256])(); // Array of pointers to CB-prefix member Opcode functions
 
-    /***** Memory Access functions - memory.cpp/mbc.cpp *****/
-    void MBC1write(WORD addr, BYTE data);
-    BYTE MBC1read(WORD addr);
+    io_read_handler io_read[IO_REGISTERS];   // Read handler of each I/O register
+    io_write_handler io_write[IO_REGISTERS]; // Write handler of each I/O register
+
+    const BYTE * read_map[MEMORY_PAGES];     // Host memory each page is read from, NULL if reads need a handler
+    BYTE * write_map[MEMORY_PAGES];          // Host memory each page is written to, NULL if writes need a handler
+
+    /***** Memory Access functions - memory.cpp/mbc.cpp/io.cpp *****/
+    void initIO();
+    void initMemoryMap();
+    void mapPages(WORD start, WORD end, const BYTE * host, bool writable);
+    void setIOHandlers(WORD addr, io_read_handler read, io_write_handler write);
     void writeByte(BYTE data, WORD addr);
     void writeWord(WORD data, WORD addr);
     BYTE readByte(WORD addr);
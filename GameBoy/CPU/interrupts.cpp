@@ -8,8 +8,6 @@
 
 #include "interrupts.h"
 
-bool halt_waited = false; // Flag used to freeze PC for one cycle before exiting HALT.
-
 void CheckInterrupts(GBCPU & CPU)
 {
     BYTE interrupt_enable = CPU.readByte(INTERRUPT_ENABLE);
@@ -27,14 +25,14 @@ void CheckInterrupts(GBCPU & CPU)
         if (CPU.halted == true)
         {
             /*
-            if (halt_waited == false)
+            if (CPU.halt_waited == false)
             {
                 // HALT bug - wait for
-                halt_waited = true;
+                CPU.halt_waited = true;
             }
             else */if ((interrupt_enable != 0x00) &&
                      (interrupt_req != 0x00)/* &&
-                     (halt_waited == true)*/)
+                     (CPU.halt_waited == true)*/)
             {
             ++CPU.PC;
             CPU.halted = false;
@@ -157,11 +155,11 @@ void StorePCOnStack(GBCPU & CPU)
     // In the case that we are coming off a HALT, reset internal flag
     CPU.halted = false;
 
-    // Push MSB first
+    // Push MSB first. Like any other write, the stack is unreachable outside HRAM during an OAM DMA transfer
     --CPU.SP;
-    CPU.MEM[CPU.SP] = ((CPU.PC) >> 8);
+    CPU.writeByte(((CPU.PC) >> 8), CPU.SP);
     --CPU.SP;
 
     // Push LSB second
-    CPU.MEM[CPU.SP] = ((CPU.PC) & 0x00FF);
+    CPU.writeByte(((CPU.PC) & 0x00FF), CPU.SP);
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*  Name:        io.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the I/O register page ($FF00 - $FF7F). Every
+                 register is read and written through a table of handlers that
+                 is shared by all memory bank controllers, so a register with
+                 side effects only needs its handler set here. */
+
+#include "GBPPU.h"
+
+
+/* Function: static BYTE ReadRegister(WORD addr, GBCPU & CPU)
+             Reads a register with no side effects. */
+static BYTE ReadRegister(WORD addr, GBCPU & CPU)
+{
+    return CPU.MEM[addr];
+}
+
+/* Function: static void WriteRegister(BYTE data, WORD addr, GBCPU & CPU)
+             Writes a register with no side effects. */
+static void WriteRegister(BYTE data, WORD addr, GBCPU & CPU)
+{
+    CPU.MEM[addr] = data;
+}
+
+/* Function: static BYTE ReadJoyPad(WORD addr, GBCPU & CPU)
+             Reads JOYPAD_P1. Input from SDL is latched on the read, otherwise
+             processing input in the main loop would overwrite key presses. */
+static BYTE ReadJoyPad(WORD addr, GBCPU & CPU)
+{
+    CPU.ProcessJoyPad();
+
+    return CPU.MEM[JOYPAD_P1];
+}
+
+/* Function: static void WriteJoyPad(BYTE data, WORD addr, GBCPU & CPU)
+             Writes JOYPAD_P1. Only the P14 and P15 outputs, which select the
+             DPAD or the buttons, can be written. */
+static void WriteJoyPad(BYTE data, WORD addr, GBCPU & CPU)
+{
+    CPU.MEM[JOYPAD_P1] = (CPU.MEM[JOYPAD_P1] & 0x0F) | (data & (P1_BUTTONS | P1_DPAD));
+}
+
+/* Function: static void WriteResetRegister(BYTE data, WORD addr, GBCPU & CPU)
+             Writes a register that is reset to 0 by any write (DIV and LY). */
+static void WriteResetRegister(BYTE data, WORD addr, GBCPU & CPU)
+{
+    CPU.MEM[addr] = 0;
+}
+
+/* Function: static void WriteSerialControl(BYTE data, WORD addr, GBCPU & CPU)
+             Writes SIO_CONTROL. Starting a transfer prints the byte being sent,
+             which is how Blargg's tests output their results. */
+static void WriteSerialControl(BYTE data, WORD addr, GBCPU & CPU)
+{
+    if (data == 0x81)
+        printf("%c", CPU.MEM[SERIAL_XFER]);
+    else
+        CPU.MEM[SIO_CONTROL] = data;
+}
+
+/* Function: static void WriteLCDControlRegister(BYTE data, WORD addr, GBCPU & CPU)
+             Writes LCDC, which can turn the LCD (and the PPU with it) on and off. */
+static void WriteLCDControlRegister(BYTE data, WORD addr, GBCPU & CPU)
+{
+    WriteLCDControl(data, CPU);
+}
+
+/* Function: static void WriteLCDStatus(BYTE data, WORD addr, GBCPU & CPU)
+             Writes STAT. The mode and coincidence bits are read only. */
+static void WriteLCDStatus(BYTE data, WORD addr, GBCPU & CPU)
+{
+    CPU.MEM[STAT] = (CPU.MEM[STAT] & 0x87) | (data & 0x78);
+}
+
+/* Function: static void WriteDMA(BYTE data, WORD addr, GBCPU & CPU)
+             Writes the DMA register, which starts a sprite DMA transfer. */
+static void WriteDMA(BYTE data, WORD addr, GBCPU & CPU)
+{
+    CPU.MEM[PPU_DMA] = data;
+    CPU.PerformDMATransfer(data);
+}
+
+// initIO - Fill the I/O register table with the handlers of every register
+void GBCPU::initIO()
+{
+    for (WORD addr = IO_START; addr <= IO_END; ++addr)
+        setIOHandlers(addr, ReadRegister, WriteRegister);
+
+    setIOHandlers(JOYPAD_P1, ReadJoyPad, WriteJoyPad);
+    setIOHandlers(SIO_CONTROL, ReadRegister, WriteSerialControl);
+    setIOHandlers(DIV, ReadRegister, WriteResetRegister);
+    setIOHandlers(LCDC, ReadRegister, WriteLCDControlRegister);
+    setIOHandlers(STAT, ReadRegister, WriteLCDStatus);
+    setIOHandlers(PPU_LY, ReadRegister, WriteResetRegister);
+    setIOHandlers(PPU_DMA, ReadRegister, WriteDMA);
+}
+
+// setIOHandlers - Set the functions that reads and writes of an I/O register go through
+void GBCPU::setIOHandlers(WORD addr, io_read_handler read, io_write_handler write)
+{
+    io_read[addr - IO_START] = read;
+    io_write[addr - IO_START] = write;
+}
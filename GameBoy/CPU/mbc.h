@@ -1,10 +0,0 @@
-#ifndef MBC_H
-#define MBC_H
-
-#include "GBCartridge.h"
-#include "GBPPU.h"
-
-
-/* TODO: delete mbc.h - no longer needed */
-
-#endif
@@ -6,89 +6,56 @@
                  access internal registers and memory for the CPU. */
 
 #include "GBCartridge.h"
+#include "rom_image.h"
+#include "mapper.h"
 #include "GBPPU.h"
+#include "context.h"
 
 
 // writeByte - Write one byte to memory
 void GBCPU::writeByte(BYTE data, WORD addr)
 {
-    if (rom_mbc_type == ROM_MBC1)
+    // Only HRAM and IO can be reached while an OAM DMA transfer is running
+    if (cycle_count < dma_end_cycle && addr <= UNUSED_END)
+        return;
+
+    // Pages backed by plain memory, including echo RAM, are written directly
+    BYTE * page = write_map[addr >> 8];
+    if (page != NULL)
     {
-        MBC1write(addr, data);
+        page[addr & 0xFF] = data;
+        return;
     }
-    else if (rom_mbc_type == ROM_ONLY)
-    {
-        // Do not write to read only memory
-        if (addr <= EXTERNAL_ROM_END)
-        {
-            printf("Writing to ROM bank at %X!\n", addr);
-        }
-
-        // If memory is written to WRAM or ECHO WRAM, write to both. Note: last 512 bytes not echoed.
-        /*else if (addr >= WRAM_START && addr <= (WRAM_END - 0x200))
-        {
-            MEM[addr] = data;
-            writeByte(data, addr + (WRAM_ECHO_START - WRAM_START));
 
-            // Only copy data when we write to WRAM_ECHO, not WRAM
-        }*/
-
-        // Write data from ECHO_WRAM to WRAM as well
-        else if (addr >= WRAM_ECHO_START && addr <= WRAM_ECHO_END)
-        {
-            MEM[addr] = data;
-            writeByte(data, addr - (WRAM_ECHO_START - WRAM_START));
-        }
-
-        // Writing to unused area in Memory Map
-        else if (addr >= 0xFEA0 && addr < 0xFEFF)
-        {
-            cout << "Restricted memory region!" << endl;
-        }
-
-        // Writing to JOYPAD_P1 should only set P14 and P15 outputs
-        else if (addr == JOYPAD_P1)
-        {
-            // If we switch between checking DPAD and BUTTONS, we need to reset the currently
-            // pressed button in order to prevent the program from thinking buttons are already pressed.
-            //if ((MEM[JOYPAD_P1] & 0x30) != data)
-                //MEM[JOYPAD_P1] = ((data & 0x30) | 0x0F);
-            MEM[JOYPAD_P1] = (MEM[JOYPAD_P1] & 0x0F) | data;
-        }
-
-        // Reset the DIV register if we're writing to it
-        else if (addr == DIV)
-            MEM[DIV] = 0;
-
-        // Reset scanline counter if written to
-        else if (addr == PPU_LY)
-            MEM[PPU_LY] = 0;
-
-        // Sprite DMA Trasnfer
-        else if (addr == PPU_DMA)
-            PerformDMATransfer(data);
-
-        // Debugging Blargg's tests. GB link registers used to output info.
-        else if (addr == SIO_CONTROL && data == 0x81) 
-            printf("%c", readByte(SERIAL_XFER));
-        
-        // Normal write
+    // I/O registers go through their handlers, HRAM and IE are plain memory, whatever the cartridge
+    if (addr >= IO_START)
+    {
+        if (addr <= IO_END)
+            (*io_write[addr - IO_START])(data, addr, *this);
         else
             MEM[addr] = data;
+
+        return;
     }
-    else
-    {
-        // MBC type not supported
-        string type = "Selected ROM type is currently not supported! \n";
 
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-            "Error 02: Unsupported ROM type",
-            type.c_str(),
-            NULL);
+    // Cartridge ROM and RAM that isn't mapped goes through the cartridge's mapper
+    if ((addr <= EXTERNAL_ROM_END) || ((addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END)))
+        cart_mapper->write(data, addr, *this);
 
-        exit(0x0002);
+    // Writing to unused area in Memory Map
+    else if (addr >= 0xFEA0 && addr < 0xFEFF)
+    {
+        cout << "Restricted memory region!" << endl;
     }
 
+    // VRAM and OAM writes are passed on to the PPU
+    else if ((addr >= VRAM_START && addr <= VRAM_END) ||
+             (addr >= SPRITE_TABLE_START && addr <= SPRITE_TABLE_END))
+        WriteVideoMemory(addr, data, *this);
+
+    // Normal write
+    else
+        MEM[addr] = data;
 }
 
 void GBCPU::writeWord(WORD data, WORD addr)
@@ -101,49 +68,37 @@ void GBCPU::writeWord(WORD data, WORD addr)
 // readByte - Read byte from memory
 BYTE GBCPU::readByte(WORD addr)
 {
-    if (rom_mbc_type == ROM_MBC1)
-    {
-        return MBC1read(addr);
-    }
-    else if (rom_mbc_type == ROM_ONLY)
+    // Only HRAM and IO can be reached while an OAM DMA transfer is running
+    if (cycle_count < dma_end_cycle && addr <= UNUSED_END)
+        return 0xFF;
+
+    // Pages backed by plain memory, including echo RAM, are read directly
+    const BYTE * page = read_map[addr >> 8];
+    if (page != NULL)
+        return page[addr & 0xFF];
+
+    // I/O registers go through their handlers, HRAM and IE are plain memory, whatever the cartridge
+    if (addr >= IO_START)
     {
-        // Read ECHO WRAM from WRAM
-        if (addr >= WRAM_ECHO_START && addr <= WRAM_ECHO_END)
-        {
-            return MEM[addr - (WRAM_ECHO_START - WRAM_START)];
-        }
-
-        // Reading from unused area in Memory Map
-        else if (addr >= 0xFEA0 && addr < 0xFEFF)
-        {
-            cout << "Restricted memory region!" << endl;
-            return 0xFF;
-        }
-
-        else if (addr == JOYPAD_P1)
-        {
-            // Trap reads to JOYPAD_P1 in order to read input from SDL, otherwise
-            // processing input in the main loop will overwrite key presses
-            ProcessJoyPad();
-
-            return MEM[JOYPAD_P1];
-        }
-        // Otherwise read from wherever
-        else
-            return MEM[addr];
+        if (addr <= IO_END)
+            return (*io_read[addr - IO_START])(addr, *this);
+
+        return MEM[addr];
     }
-    else
+
+    // Cartridge ROM and RAM that isn't mapped goes through the cartridge's mapper
+    if ((addr <= EXTERNAL_ROM_END) || ((addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END)))
+        return cart_mapper->read(addr, *this);
+
+    // Reading from unused area in Memory Map
+    if (addr >= 0xFEA0 && addr < 0xFEFF)
     {
-        // MBC type not supported
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-                                 "Error 02: Unsupported ROM type",
-                                 "Selected ROM type is currently not supported!",
-                                 NULL);
-
-        exit(0x002);
-        return 0x00;
+        cout << "Restricted memory region!" << endl;
+        return 0xFF;
     }
 
+    // Otherwise read from wherever
+    return MEM[addr];
 }
 
 
@@ -155,11 +110,11 @@ void GBCPU::ProcessJoyPad()
     // to the nature of how key presses are stored in memory
     if (!(MEM[JOYPAD_P1] & P1_BUTTONS))
         // Button key presses enabled
-        MEM[JOYPAD_P1] = (MEM[JOYPAD_P1] & 0x30) | (GB_buttons & 0x0F);
+        MEM[JOYPAD_P1] = (MEM[JOYPAD_P1] & 0x30) | (gb->joypad.buttons & 0x0F);
 
     else if (!(MEM[JOYPAD_P1] & P1_DPAD))
         // DPAD key presses enabled
-        MEM[JOYPAD_P1] = (MEM[JOYPAD_P1] & 0x30) | (GB_dpad & 0x0F);
+        MEM[JOYPAD_P1] = (MEM[JOYPAD_P1] & 0x30) | (gb->joypad.dpad & 0x0F);
 
     //else
         // No key presses enabled
@@ -194,13 +149,65 @@ WORD GBCPU::readImmWord()
     return temp;
 }
 
+// initMemoryMap - Point every page that is plain memory at the host bytes behind it. Echo RAM
+// pages point at the WRAM they mirror, so both see the same bytes
+void GBCPU::initMemoryMap()
+{
+    for (int page = 0; page < MEMORY_PAGES; ++page)
+    {
+        read_map[page] = NULL;
+        write_map[page] = NULL;
+    }
+
+    // ROM bank #0. The cartridge's mapper maps the switchable banks
+    mapPages(ROM_START, ROM_END, rom->data, false);
+
+    // VRAM is read directly, but writes are passed on to the PPU
+    mapPages(VRAM_START, VRAM_END, &MEM[VRAM_START], false);
+
+    mapPages(WRAM_START, WRAM_END, &MEM[WRAM_START], true);
+    mapPages(WRAM_ECHO_START, WRAM_ECHO_END, &MEM[WRAM_START], true);
+
+    // Put the cartridge's mapper in its power-on state, which maps its initial banks
+    cart_mapper->reset(*this);
+}
+
+// mapPages - Map the pages from start to end onto consecutive host memory, for reads and optionally writes
+void GBCPU::mapPages(WORD start, WORD end, const BYTE * host, bool writable)
+{
+    for (int page = start >> 8; page <= (end >> 8); ++page)
+    {
+        read_map[page] = host + ((page - (start >> 8)) << 8);
+        write_map[page] = writable ? (BYTE *)read_map[page] : NULL;
+    }
+}
+
 void GBCPU::PerformDMATransfer(BYTE source)
 {
-    // The real source address is multiplied by 0x100 which is 256, which essentially left shift by 8. 
-    for (WORD addr = 0x00; addr <= 0x9F; ++addr)
+    // Sources past WRAM read from echo RAM, which mirrors WRAM
+    if (source >= (WRAM_ECHO_START >> 8))
+        source -= (WRAM_ECHO_START - WRAM_START) >> 8;
+
+    // The real source address is multiplied by 0x100 which is 256, which essentially left shift by 8.
+    WORD addr = (WORD)source << 8;
+
+    // Resolve the source page once and copy it into OAM as a whole
+    static const BYTE open_bus[SPRITE_TABLE_END - SPRITE_TABLE_START + 1] = { 0 };
+    const BYTE * page = read_map[source];
+
+    // Cartridge pages the mapper leaves unmapped (disabled RAM) read as open bus
+    if (page == NULL)
     {
-        writeByte(readByte((((WORD)source << 8) | (addr))), SPRITE_TABLE_START + addr);
+        if (addr >= EXTERNAL_RAM_START && addr <= EXTERNAL_RAM_END)
+            page = open_bus;
+        else
+            page = &MEM[addr];
     }
+
+    WriteSpriteTable(page, *this);
+
+    // The CPU is locked out of everything but HRAM and IO until the transfer would have finished
+    dma_end_cycle = cycle_count + DMA_CYCLES;
 }
 
 
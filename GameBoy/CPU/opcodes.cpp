@@ -682,7 +682,7 @@ void GBCPU::OP14() { INCR(D); ++PC; cycles = 4; }
 void GBCPU::OP15() { DECR(D); ++PC; cycles = 4; }                               // DEC D
 void GBCPU::OP16() { D = readImmByte(); PC += 2; cycles = 8; }                  // LD A, #
 void GBCPU::OP17() { RLA(); ++PC; cycles = 4; }                                 // RLA
-void GBCPU::OP18() { JR(); cycles = 8; }                                        // JR
+void GBCPU::OP18() { JR(); cycles = 12; }                                       // JR
 void GBCPU::OP19() { ADD(GetDE()); ++PC; cycles = 8; }                          // ADD HL, DE
 void GBCPU::OP1A() { A = readByte(GetDE()); ++PC; cycles = 8; }                 // LD A, (DE)
 void GBCPU::OP1B() { WORD temp = GetDE() - 1; SetDE(temp); ++PC; cycles = 8; }  // DEC DE
@@ -691,7 +691,7 @@ void GBCPU::OP1D() { DECR(E); ++PC; cycles = 4; }
 void GBCPU::OP1E() { E = readImmByte(); PC += 2; cycles = 8; }                  // LD E, #
 void GBCPU::OP1F() { RRA(); ++PC; cycles = 4; }                                 // RRA
 
-void GBCPU::OP20() { if (ZERO_FLAG == false) JR(); else PC += 2; cycles = 8; }  // JR NZ
+void GBCPU::OP20() { if (ZERO_FLAG == false) { JR(); cycles = 12; } else { PC += 2; cycles = 8; } }  // JR NZ
 void GBCPU::OP21() { SetHL(readImmWord()); PC += 3; cycles = 12; }              // LD HL, ##
 void GBCPU::OP22() { writeByte(A, GetHL()); INC(H, L); ++PC; cycles = 8; }      // LD (HL++), A
 void GBCPU::OP23() { WORD temp = GetHL() + 1; SetHL(temp); ++PC; cycles = 8; }  // INC HL
@@ -699,7 +699,7 @@ void GBCPU::OP24() { INCR(H); ++PC; cycles = 4; }
 void GBCPU::OP25() { DECR(H); ++PC; cycles = 4; }                               // DEC H
 void GBCPU::OP26() { H = readImmByte(); PC += 2; cycles = 8; }                  // LD H, #
 void GBCPU::OP27() { DAA(); ++PC; cycles = 4; }                                 // DAA
-void GBCPU::OP28() { if (ZERO_FLAG == true) JR(); else PC += 2; cycles = 8; }   // JR z
+void GBCPU::OP28() { if (ZERO_FLAG == true) { JR(); cycles = 12; } else { PC += 2; cycles = 8; } }   // JR z
 void GBCPU::OP29() { ADD(GetHL()); ++PC; cycles = 8; }                          // ADD HL, HL
 void GBCPU::OP2A() { A = readByte(GetHL()); INC(H, L); ++PC; cycles = 8; }      // LD A, (HL++)
 void GBCPU::OP2B() { WORD temp = GetHL() - 1; SetHL(temp); ++PC; cycles = 8; }  // DEC HL
@@ -709,7 +709,7 @@ void GBCPU::OP2E() { L = readImmByte(); PC += 2; cycles = 8; }
 void GBCPU::OP2F() { A = ~A; SUBTRACT_FLAG = true;                              // CPL (flip all bits)
                      HALF_CARRY_FLAG = true; ++PC; cycles = 4; }
 
-void GBCPU::OP30() { if (CARRY_FLAG == false) JR(); else PC += 2; cycles = 8; }                                  // JR nc
+void GBCPU::OP30() { if (CARRY_FLAG == false) { JR(); cycles = 12; } else { PC += 2; cycles = 8; } }  // JR nc
 void GBCPU::OP31() { SP = readImmWord(); PC += 3; cycles = 12; }                                                 // LD SP, ##
 void GBCPU::OP32() { writeByte(A, GetHL()); DEC(H, L); ++PC; cycles = 8; }                                       // LD (HL--), A
 void GBCPU::OP33() { ++SP; ++PC; cycles = 8; }                                                                   // INC SP
@@ -717,7 +717,7 @@ void GBCPU::OP34() { BYTE t = readByte(GetHL()); INCR(t); writeByte(t, GetHL());
 void GBCPU::OP35() { BYTE t = readByte(GetHL()); DECR(t); writeByte(t, GetHL()); ++PC; cycles = 12; }            // DEC (HL)
 void GBCPU::OP36() { writeByte(readImmByte(), GetHL()); PC += 2; cycles = 12; }                                  // LD (HL), #
 void GBCPU::OP37() { CARRY_FLAG = true; SUBTRACT_FLAG = false; HALF_CARRY_FLAG = false; ++PC; cycles = 4; }      // SCF
-void GBCPU::OP38() { if (CARRY_FLAG == true) JR(); else PC += 2; cycles = 8; }                                   // JR, c
+void GBCPU::OP38() { if (CARRY_FLAG == true) { JR(); cycles = 12; } else { PC += 2; cycles = 8; } }  // JR, c
 void GBCPU::OP39() { ADD(SP); ++PC; cycles = 8; }                                                                // ADD HL, SP 
 void GBCPU::OP3A() { A = readByte(GetHL()); DEC(H, L); ++PC; cycles = 8; }                                       // LD A, (HL--)
 void GBCPU::OP3B() { --SP; ++PC; cycles = 8; }                                                                   // --SP
@@ -879,7 +879,7 @@ void GBCPU::OPC7() { RST(0x00); cycles = 32; }
 void GBCPU::OPC8() { if (ZERO_FLAG == true) RET(); else ++PC; cycles = 8; }
 void GBCPU::OPC9() { RET(); cycles = 8; }
 void GBCPU::OPCA() { if (ZERO_FLAG == true) JP(); else PC += 3; cycles = 12; }
-void GBCPU::OPCB() { (this->*(CBopcodes)[MEM[PC+1]])(); /*cout << "CB Opcode called!" << endl;*/ /* PREFIX CB OPCODES - DO NOT USE. */ }
+void GBCPU::OPCB() { (this->*(CBopcodes)[readImmByte()])(); /*cout << "CB Opcode called!" << endl;*/ /* PREFIX CB OPCODES - DO NOT USE. */ }
 void GBCPU::OPCC() { if (ZERO_FLAG == true) CALL(); else PC += 3; cycles = 12; }
 void GBCPU::OPCD() { CALL(); cycles = 12; } // CALL nn
 void GBCPU::OPCE() { ADDC(readImmByte()); PC += 2; cycles = 8; }
@@ -9,9 +9,21 @@
 
 using namespace std;
 
+// What the cartridge header says about the game and its memory
+typedef struct cartridge_info
+{
+    size_t rom_size;        // Actual total ROM size in bytes
+    size_t ram_size;        // Actual total RAM size in bytes
+    size_t ext_rom_size;    // Size of external ROM in bytes
+    size_t ext_ram_size;    // Size of external RAM in bytes
+    MBC_TYPES rom_mbc_type; // The MBC cartridge type
+    char rom_name[17];      // The 16-byte name specified in the cartridge from $134-143
+} cartridge_info;
+
 void load_rom(string rom_name, GBCPU & cpu);
+void unload_rom(GBCPU & cpu);
 
-void extract_header(GBCPU & cpu);
-void initialize_rom_ram_size();
+void extract_header(const BYTE * rom, GBCPU & cpu);
+void initialize_rom_ram_size(GBCPU & cpu);
 
 #endif /* GBCartridge.h */
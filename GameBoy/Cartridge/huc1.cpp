@@ -0,0 +1,88 @@
+/*  Name:        huc1.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains Hudson's HuC1 memory bank controller: up to
+                 64 ROM banks, up to 4 RAM banks, and an infrared port that
+                 takes the place of RAM at $A000 - $BFFF when selected. */
+
+#include "mapper.h"
+#include "save_ram.h"
+#include "context.h"
+
+
+/* Function: static void HuC1Reset(GBCPU & CPU)
+             Selects ROM bank #1 and RAM bank #0, with RAM at $A000 - $BFFF. */
+static void HuC1Reset(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    mbc.huc1_rom_bank = 1;
+    mbc.huc1_ram_bank = 0;
+    mbc.huc1_ir_mode = false;
+    mbc.ram_bank_access_enabled = true;
+
+    MapROMBank(mbc.huc1_rom_bank, CPU);
+    MapRAMBank(mbc.huc1_ram_bank, mbc.ram_bank_access_enabled, CPU);
+}
+
+/* Function: static BYTE HuC1Read(WORD addr, GBCPU & CPU)
+             Reads the infrared port, which never sees any light. Missing RAM
+             reads as open bus. */
+static BYTE HuC1Read(WORD addr, GBCPU & CPU)
+{
+    return CPU.gb->mbc.huc1_ir_mode ? 0xC0 : 0xFF;
+}
+
+/* Function: static void HuC1Write(BYTE data, WORD addr, GBCPU & CPU)
+             Writes the HuC1 control registers, or battery-backed RAM, which is
+             only mapped for reads so that its writes can be tracked. */
+static void HuC1Write(BYTE data, WORD addr, GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    // A write of $0E to $0000 - $1FFF selects the infrared port, anything else selects RAM. HuC1 has no RAM enable
+    if (addr <= 0x1FFF)
+    {
+        bool ir_mode = (data & 0x0F) == 0x0E;
+
+        // Games switch RAM out once they are done saving, so write save RAM out now
+        if (ir_mode && (mbc.huc1_ir_mode == false))
+            FlushSaveRAM(CPU);
+
+        mbc.huc1_ir_mode = ir_mode;
+        mbc.ram_bank_access_enabled = (ir_mode == false);
+        MapRAMBank(mbc.huc1_ram_bank, mbc.ram_bank_access_enabled, CPU);
+    }
+
+    // $2000 - $3FFF selects the 6-bit ROM bank. Bank #0 selects bank #1 instead
+    else if (addr <= ROM_END)
+    {
+        mbc.huc1_rom_bank = (data & 0x3F) ? (data & 0x3F) : 1;
+        MapROMBank(mbc.huc1_rom_bank, CPU);
+    }
+
+    // $4000 - $5FFF selects the RAM bank
+    else if (addr <= 0x5FFF)
+    {
+        mbc.huc1_ram_bank = data & 0x03;
+        MapRAMBank(mbc.huc1_ram_bank, mbc.ram_bank_access_enabled, CPU);
+    }
+
+    // Battery-backed RAM, which is marked dirty for the next flush of the .sav file. Writes to the
+    // infrared port would switch its LED, which has nothing to talk to
+    else if (mbc.ram_bank_access_enabled && (addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END))
+    {
+        BYTE * ram = GetRAMAddress(mbc.huc1_ram_bank, addr, CPU);
+
+        if (ram != NULL)
+        {
+            *ram = data;
+            CPU.ext_ram_dirty = true;
+        }
+    }
+
+    // $6000 - $7FFF has no register on HuC1
+}
+
+const mapper huc1_mapper = { "HuC1", HuC1Reset, HuC1Read, HuC1Write, NULL };
@@ -0,0 +1,144 @@
+/*  Name:        mapper.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the pieces shared by every cartridge mapper:
+                 picking the mapper for a cartridge type, and remapping the
+                 CPU's page tables when a ROM or RAM bank is switched. It also
+                 contains the mapper of cartridges with no bank controller. */
+
+#include "mapper.h"
+#include "rom_image.h"
+#include "save_ram.h"
+#include "context.h"
+
+
+/* Function: static void ROMOnlyReset(GBCPU & CPU)
+             Maps the whole 32 KByte ROM, and external RAM if there is any.
+             Without RAM in the header, $A000 - $BFFF is plain memory. */
+static void ROMOnlyReset(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    mbc.ram_bank_access_enabled = true;
+
+    MapROMBank(1, CPU);
+
+    if (CPU.gb->cart.ext_ram_size > 0)
+        MapRAMBank(0, mbc.ram_bank_access_enabled, CPU);
+    else
+        CPU.mapPages(EXTERNAL_RAM_START, EXTERNAL_RAM_END, &CPU.MEM[EXTERNAL_RAM_START], true);
+}
+
+/* Function: static BYTE ROMOnlyRead(WORD addr, GBCPU & CPU)
+             Missing RAM reads as open bus. */
+static BYTE ROMOnlyRead(WORD addr, GBCPU & CPU)
+{
+    return 0xFF;
+}
+
+/* Function: static void ROMOnlyWrite(BYTE data, WORD addr, GBCPU & CPU)
+             Writes battery-backed RAM, which is only mapped for reads so that
+             its writes can be tracked. Writes to ROM are ignored. */
+static void ROMOnlyWrite(BYTE data, WORD addr, GBCPU & CPU)
+{
+    if ((addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END))
+    {
+        BYTE * ram = GetRAMAddress(0, addr, CPU);
+
+        if (ram != NULL)
+        {
+            *ram = data;
+            CPU.ext_ram_dirty = true;
+        }
+    }
+}
+
+const mapper rom_only_mapper = { "ROM only", ROMOnlyReset, ROMOnlyRead, ROMOnlyWrite, NULL };
+
+
+const mapper * GetMapper(MBC_TYPES type)
+{
+    switch (type)
+    {
+    case ROM_ONLY:
+    case ROM_RAM:
+    case ROM_RAM_BATT:
+        return &rom_only_mapper;
+
+    case ROM_MBC1:
+    case ROM_MBC1_RAM:
+    case ROM_MBC1_RAM_BATT:
+        return &mbc1_mapper;
+
+    case ROM_MBC2:
+    case ROM_MBC2_BATT:
+        return &mbc2_mapper;
+
+    case ROM_MBC3_TIMER_BATT:
+    case ROM_MBC3_TIMER_RAM_BATT:
+    case ROM_MBC3:
+    case ROM_MBC3_RAM:
+    case ROM_MBC3_RAM_BATT:
+        return &mbc3_mapper;
+
+    case ROM_MBC5:
+    case ROM_MBC5_RAM:
+    case ROM_MBC5_RAM_BATT:
+    case ROM_MBC5_RUMBLE:
+    case ROM_MBC5_RUMBLE_SRAM:
+    case ROM_MBC5_RUMBLE_SRAM_BATT:
+        return &mbc5_mapper;
+
+    case HUDSON_HUC_1:
+        return &huc1_mapper;
+
+    default:
+        return NULL;
+    }
+}
+
+bool HasRTC(MBC_TYPES type)
+{
+    return (type == ROM_MBC3_TIMER_BATT) || (type == ROM_MBC3_TIMER_RAM_BATT);
+}
+
+void MapROMBank(unsigned int bank, GBCPU & CPU)
+{
+    // The image holds at least banks #0 and #1
+    unsigned int banks = (unsigned int)(CPU.rom->size / 0x4000);
+
+    CPU.mapPages(EXTERNAL_ROM_START, EXTERNAL_ROM_END, &CPU.rom->data[(bank % banks) * 0x4000], false);
+}
+
+BYTE * GetRAMAddress(unsigned int bank, WORD addr, GBCPU & CPU)
+{
+    // Cartridges with only 2 KBytes of RAM leave the rest of the bank empty
+    size_t bank_size = (CPU.gb->cart.ext_ram_size < 0x2000) ? CPU.gb->cart.ext_ram_size : 0x2000;
+    size_t offset = addr - EXTERNAL_RAM_START;
+
+    if (offset >= bank_size)
+        return NULL;
+
+    // Banks past the end of RAM wrap around
+    unsigned int banks = (unsigned int)(CPU.gb->cart.ext_ram_size / bank_size);
+
+    return &CPU.ext_ram[(bank % banks) * bank_size + offset];
+}
+
+void MapRAMBank(unsigned int bank, bool enabled, GBCPU & CPU)
+{
+    // Unmapped pages are left to the mapper, which reads them as open bus
+    for (int page = EXTERNAL_RAM_START >> 8; page <= (EXTERNAL_RAM_END >> 8); ++page)
+    {
+        CPU.read_map[page] = NULL;
+        CPU.write_map[page] = NULL;
+    }
+
+    if ((enabled == false) || (CPU.gb->cart.ext_ram_size == 0))
+        return;
+
+    size_t bank_size = (CPU.gb->cart.ext_ram_size < 0x2000) ? CPU.gb->cart.ext_ram_size : 0x2000;
+
+    CPU.mapPages(EXTERNAL_RAM_START, EXTERNAL_RAM_START + bank_size - 1, GetRAMAddress(bank, EXTERNAL_RAM_START, CPU), CPU.save == NULL);
+}
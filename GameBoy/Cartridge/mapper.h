@@ -0,0 +1,98 @@
+#ifndef MAPPER_H
+#define MAPPER_H
+
+#include "GBCPU.h"
+
+// A cartridge's memory bank controller. Switchable ROM and RAM banks are
+// mapped straight into the CPU's page tables, so banked memory is read like
+// any other memory and a mapper is only called for the pages it leaves
+// unmapped: its control registers and disabled (or write-tracked) RAM.
+typedef struct mapper
+{
+    const char * name;
+    void (*reset)(GBCPU & CPU);                        // Puts the controller in its power-on state and maps its initial banks
+    BYTE (*read)(WORD addr, GBCPU & CPU);              // Reads an unmapped cartridge address ($0000 - $7FFF, $A000 - $BFFF)
+    void (*write)(BYTE data, WORD addr, GBCPU & CPU);  // Writes an unmapped cartridge address ($0000 - $7FFF, $A000 - $BFFF)
+    void (*close)(GBCPU & CPU);                        // Stores any state kept in the .sav file before it is closed. May be NULL
+} mapper;
+
+// Bytes of RAM built into MBC2: 512 values of 4 bits, one per byte
+#define MBC2_RAM_SIZE 512
+
+// Bytes of real-time clock state kept after external RAM in the .sav file: the
+// current and latched S, M, H, DL and DH registers as 32-bit values, then a
+// 64-bit UNIX timestamp of when they were saved (the layout other emulators use)
+#define RTC_SAVE_SIZE 48
+
+// The MBC3 real-time clock. It is never ticked: its value is worked out from
+// the time passed since a reference point whenever it is latched or written.
+typedef struct rtc_clock
+{
+    unsigned long long seconds;    // Clock value in seconds (days, hours, minutes and seconds) at the reference time
+    unsigned long long reference;  // When seconds was taken: cycle_count, or host seconds since the epoch with rtc_host_time
+    bool halted;                   // DH bit 6. The clock is stopped
+    bool carry;                    // DH bit 7. The 9-bit day counter overflowed
+    BYTE latched[5];               // S, M, H, DL and DH as of the last latch, which is what the game reads
+    BYTE latch;                    // Last value written to $6000 - $7FFF. Writing $00 then $01 latches the clock
+} rtc_clock;
+
+// Bank registers of the memory bank controllers. Only the fields of the
+// cartridge's own controller are used
+typedef struct mapper_state
+{
+    bool ram_bank_access_enabled;    // Indicates if RAM read/writes are enabled
+
+    /* MBC1 state (mbc1.cpp) */
+    memory_model_types memory_model; // The current maximum memory model for MBC1
+    BYTE current_rom_bank;           // The current switchable rom bank being used by MBC1
+    BYTE current_ram_bank;           // The current switchable ram bank beign used by MBC1
+
+    /* MBC2 state (mbc2.cpp) */
+    BYTE mbc2_rom_bank;   // The 4-bit ROM bank mapped at $4000 - $7FFF
+
+    /* MBC3 state (mbc3.cpp) */
+    BYTE mbc3_rom_bank;   // The 7-bit ROM bank mapped at $4000 - $7FFF
+    BYTE mbc3_ram_bank;   // The RAM bank ($00 - $03) or RTC register ($08 - $0C) mapped at $A000 - $BFFF
+    rtc_clock mbc3_rtc;   // The real-time clock (timer cartridges only)
+    bool rtc_host_time;   // The clock follows the host's wall time rather than emulated time
+
+    /* HuC1 state (huc1.cpp) */
+    BYTE huc1_rom_bank;   // The 6-bit ROM bank mapped at $4000 - $7FFF
+    BYTE huc1_ram_bank;   // The 2-bit RAM bank mapped at $A000 - $BFFF
+    bool huc1_ir_mode;    // The infrared port takes the place of RAM at $A000 - $BFFF
+
+    /* MBC5 state (mbc5.cpp) */
+    WORD mbc5_rom_bank;   // The 9-bit ROM bank mapped at $4000 - $7FFF
+    BYTE mbc5_ram_bank;   // The 4-bit RAM bank mapped at $A000 - $BFFF
+    bool mbc5_rumble;     // The rumble motor is on (rumble cartridges only)
+} mapper_state;
+
+/* Mappers (mapper.cpp, mbc1.cpp, mbc2.cpp, mbc3.cpp, mbc5.cpp, huc1.cpp) */
+extern const mapper rom_only_mapper;
+extern const mapper mbc1_mapper;
+extern const mapper mbc2_mapper;
+extern const mapper mbc3_mapper;
+extern const mapper mbc5_mapper;
+extern const mapper huc1_mapper;
+
+// Returns the mapper of a cartridge type, or NULL if the type isn't supported
+const mapper * GetMapper(MBC_TYPES type);
+
+// Returns true if the cartridge type has a real-time clock
+bool HasRTC(MBC_TYPES type);
+
+// Picks the time source of the MBC3 real-time clock, before the game starts running. The clock is
+// restored from the .sav file again, so that with host time the time passed since it was saved counts
+void SetRTCHostTime(bool enabled, GBCPU & CPU);
+
+// Maps a 16 Kbyte ROM bank at $4000 - $7FFF. Banks past the end of the ROM wrap around
+void MapROMBank(unsigned int bank, GBCPU & CPU);
+
+// Returns the external RAM behind an address in $A000 - $BFFF with the given bank selected, or NULL if there is none
+BYTE * GetRAMAddress(unsigned int bank, WORD addr, GBCPU & CPU);
+
+// Maps an 8 Kbyte external RAM bank at $A000 - $BFFF, or leaves it to the mapper if RAM is disabled.
+// Battery-backed RAM is only mapped for reads, so writes reach the mapper and mark it dirty
+void MapRAMBank(unsigned int bank, bool enabled, GBCPU & CPU);
+
+#endif /* mapper.h */
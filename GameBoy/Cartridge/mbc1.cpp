@@ -0,0 +1,120 @@
+/*  Name:        mbc1.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     August 30th, 2016
+    Modified:    October 19th, 2026
+    Description: This file contains the MBC1 memory bank controller: up to 128
+                 ROM banks and up to 4 RAM banks, sharing two upper bank bits
+                 that the banking mode gives to either ROM or RAM. */
+
+#include "mapper.h"
+#include "rom_image.h"
+#include "save_ram.h"
+#include "context.h"
+
+
+/* Function: static unsigned int GetMBC1RAMBank(GBCPU & CPU)
+             Returns the RAM bank in use. Only the RAM banking mode (4/32) can
+             switch RAM banks. */
+static unsigned int GetMBC1RAMBank(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    return (mbc.memory_model == ram_banking) ? mbc.current_ram_bank : 0;
+}
+
+/* Function: static void MapMBC1Banks(GBCPU & CPU)
+             Maps the banks selected by the bank registers and banking mode. */
+static void MapMBC1Banks(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    // In RAM banking mode the upper bank bits also switch $0000 - $3FFF, which matters for ROMs over 512 KBytes
+    unsigned int banks = (unsigned int)(CPU.rom->size / 0x4000);
+    unsigned int bank0 = (mbc.memory_model == ram_banking) ? (mbc.current_ram_bank << 5) : 0;
+
+    CPU.mapPages(ROM_START, ROM_END, &CPU.rom->data[(bank0 % banks) * 0x4000], false);
+    MapROMBank(mbc.current_rom_bank, CPU);
+    MapRAMBank(GetMBC1RAMBank(CPU), mbc.ram_bank_access_enabled, CPU);
+}
+
+/* Function: static void MBC1Reset(GBCPU & CPU)
+             Selects ROM bank #1 and RAM bank #0 in ROM banking mode, with RAM
+             disabled. */
+static void MBC1Reset(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    mbc.memory_model = rom_banking;
+    mbc.current_rom_bank = 1;
+    mbc.current_ram_bank = 0;
+    mbc.ram_bank_access_enabled = false;
+
+    MapMBC1Banks(CPU);
+}
+
+/* Function: static BYTE MBC1Read(WORD addr, GBCPU & CPU)
+             Disabled or missing RAM reads as open bus. */
+static BYTE MBC1Read(WORD addr, GBCPU & CPU)
+{
+    return 0xFF;
+}
+
+/* Function: static void MBC1Write(BYTE data, WORD addr, GBCPU & CPU)
+             Writes the MBC1 control registers, or battery-backed RAM, which is
+             only mapped for reads so that its writes can be tracked. */
+static void MBC1Write(BYTE data, WORD addr, GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    // A write (XXXX 1010b) to the lower half of internal ROM enables switchable RAM, anything else disables it
+    if (addr <= 0x1FFF)
+    {
+        bool enabled = ((data & 0x0F) == 0x0A);
+
+        // Games disable RAM once they are done saving, so write save RAM out now
+        if (mbc.ram_bank_access_enabled && (enabled == false))
+            FlushSaveRAM(CPU);
+
+        mbc.ram_bank_access_enabled = enabled;
+        MapRAMBank(GetMBC1RAMBank(CPU), mbc.ram_bank_access_enabled, CPU);
+    }
+
+    // A write (XXXB BBBBb) to the upper half of internal ROM selects the lower 5 bits of the ROM bank.
+    // Bank #0 selects the next bank instead, which also skips banks #20, #40 and #60
+    else if (addr <= ROM_END)
+    {
+        BYTE bank = (data & 0x1F) ? (data & 0x1F) : 1;
+
+        mbc.current_rom_bank = (mbc.current_rom_bank & 0x60) | bank;
+        MapROMBank(mbc.current_rom_bank, CPU);
+    }
+
+    // A write (XXXX XXBBb) to the lower half of switchable ROM selects the RAM bank and upper ROM bank bits
+    else if (addr <= 0x5FFF)
+    {
+        mbc.current_ram_bank = data & 0x03;
+        mbc.current_rom_bank = (mbc.current_rom_bank & 0x1F) | (mbc.current_ram_bank << 5);
+        MapMBC1Banks(CPU);
+    }
+
+    // A write (XXXX XXX1b) to the upper half of switchable ROM selects the ROM/RAM banking mode
+    else if (addr <= EXTERNAL_ROM_END)
+    {
+        mbc.memory_model = (data & 0x01) ? ram_banking : rom_banking;
+        MapMBC1Banks(CPU);
+    }
+
+    // Battery-backed RAM, which is marked dirty for the next flush of the .sav file
+    else if (mbc.ram_bank_access_enabled && (addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END))
+    {
+        BYTE * ram = GetRAMAddress(GetMBC1RAMBank(CPU), addr, CPU);
+
+        if (ram != NULL)
+        {
+            *ram = data;
+            CPU.ext_ram_dirty = true;
+        }
+    }
+}
+
+const mapper mbc1_mapper = { "MBC1", MBC1Reset, MBC1Read, MBC1Write, NULL };
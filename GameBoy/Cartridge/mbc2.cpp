@@ -0,0 +1,101 @@
+/*  Name:        mbc2.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the MBC2 memory bank controller: up to 16
+                 ROM banks and 512 x 4 bits of RAM built into the controller.
+                 The RAM repeats across $A000 - $BFFF, which is done by pointing
+                 every 512 byte block of pages at the same two host pages. */
+
+#include "mapper.h"
+#include "save_ram.h"
+#include "context.h"
+
+
+/* Function: static void MapMBC2RAM(GBCPU & CPU)
+             Maps the built-in RAM, if enabled, for reads at every mirror.
+             Writes go through the mapper, which keeps the upper 4 bits set. */
+static void MapMBC2RAM(GBCPU & CPU)
+{
+    if (CPU.gb->mbc.ram_bank_access_enabled == false)
+    {
+        MapRAMBank(0, false, CPU);
+        return;
+    }
+
+    for (WORD addr = EXTERNAL_RAM_START; addr < EXTERNAL_RAM_END; addr += MBC2_RAM_SIZE)
+        CPU.mapPages(addr, addr + MBC2_RAM_SIZE - 1, CPU.ext_ram, false);
+}
+
+/* Function: static void MBC2Reset(GBCPU & CPU)
+             Selects ROM bank #1, with RAM disabled. */
+static void MBC2Reset(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    mbc.mbc2_rom_bank = 1;
+    mbc.ram_bank_access_enabled = false;
+
+    // Each byte holds one 4-bit value, with the upper 4 bits read as 1s. A .sav file may hold anything there
+    for (size_t i = 0; i < MBC2_RAM_SIZE; ++i)
+    {
+        if ((CPU.ext_ram[i] & 0xF0) != 0xF0)
+        {
+            CPU.ext_ram[i] |= 0xF0;
+            CPU.ext_ram_dirty = true;
+        }
+    }
+
+    MapROMBank(mbc.mbc2_rom_bank, CPU);
+    MapMBC2RAM(CPU);
+}
+
+/* Function: static BYTE MBC2Read(WORD addr, GBCPU & CPU)
+             Disabled RAM reads as open bus. */
+static BYTE MBC2Read(WORD addr, GBCPU & CPU)
+{
+    return 0xFF;
+}
+
+/* Function: static void MBC2Write(BYTE data, WORD addr, GBCPU & CPU)
+             Writes the MBC2 control registers, or the built-in RAM, which only
+             stores the lower 4 bits. */
+static void MBC2Write(BYTE data, WORD addr, GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    // $0000 - $3FFF holds both registers, told apart by address bit 8
+    if (addr <= ROM_END)
+    {
+        // Bit 8 set: the lower 4 bits select the ROM bank. Bank #0 selects bank #1 instead
+        if (addr & 0x0100)
+        {
+            mbc.mbc2_rom_bank = (data & 0x0F) ? (data & 0x0F) : 1;
+            MapROMBank(mbc.mbc2_rom_bank, CPU);
+        }
+
+        // Bit 8 clear: a write (XXXX 1010b) enables RAM, anything else disables it
+        else
+        {
+            bool enabled = ((data & 0x0F) == 0x0A);
+
+            // Games disable RAM once they are done saving, so write save RAM out now
+            if (mbc.ram_bank_access_enabled && (enabled == false))
+                FlushSaveRAM(CPU);
+
+            mbc.ram_bank_access_enabled = enabled;
+            MapMBC2RAM(CPU);
+        }
+    }
+
+    // Built-in RAM, marked dirty for the next flush of the .sav file
+    else if (mbc.ram_bank_access_enabled && (addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END))
+    {
+        CPU.ext_ram[addr & (MBC2_RAM_SIZE - 1)] = data | 0xF0;
+        CPU.ext_ram_dirty = true;
+    }
+
+    // $4000 - $7FFF has no register on MBC2
+}
+
+const mapper mbc2_mapper = { "MBC2", MBC2Reset, MBC2Read, MBC2Write, NULL };
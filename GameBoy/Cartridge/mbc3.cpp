@@ -0,0 +1,330 @@
+/*  Name:        mbc3.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the MBC3 memory bank controller: up to 128
+                 ROM banks, up to 4 RAM banks and, on timer cartridges, a
+                 real-time clock. The clock costs nothing while the game runs:
+                 it is only worked out from the emulated cycle count (or the
+                 host's wall time) when the game latches or sets it. */
+
+#include "mapper.h"
+#include "save_ram.h"
+#include "context.h"
+#include <ctime>
+
+// RTC registers, selected by writing $08 - $0C to $4000 - $5FFF
+#define RTC_S   0x08
+#define RTC_M   0x09
+#define RTC_H   0x0A
+#define RTC_DL  0x0B
+#define RTC_DH  0x0C
+
+#define RTC_DAY_SECONDS  (24 * 60 * 60)
+#define RTC_MAX_SECONDS  (512ULL * RTC_DAY_SECONDS) // The day counter is 9 bits
+
+
+/* Function: static unsigned long long GetRTCTime(GBCPU & CPU)
+             Returns the time the clock follows, in units of GetRTCUnits(). */
+static unsigned long long GetRTCTime(GBCPU & CPU)
+{
+    return CPU.gb->mbc.rtc_host_time ? (unsigned long long)time(NULL) : CPU.cycle_count;
+}
+
+/* Function: static unsigned long long GetRTCUnits(GBCPU & CPU)
+             Returns the number of GetRTCTime() units in a second. */
+static unsigned long long GetRTCUnits(GBCPU & CPU)
+{
+    return CPU.gb->mbc.rtc_host_time ? 1 : SAVE_CYCLES_PER_SECOND;
+}
+
+/* Function: static void UpdateRTC(GBCPU & CPU)
+             Adds the whole seconds passed since the reference time to the
+             clock, keeping any fraction of a second for the next update. */
+static void UpdateRTC(GBCPU & CPU)
+{
+    rtc_clock & rtc = CPU.gb->mbc.mbc3_rtc;
+
+    unsigned long long now = GetRTCTime(CPU);
+
+    // A stopped clock, or a host clock that went backwards, only moves the reference
+    if (rtc.halted || (now < rtc.reference))
+    {
+        rtc.reference = now;
+        return;
+    }
+
+    unsigned long long elapsed = (now - rtc.reference) / GetRTCUnits(CPU);
+    rtc.seconds += elapsed;
+    rtc.reference += elapsed * GetRTCUnits(CPU);
+
+    if (rtc.seconds >= RTC_MAX_SECONDS)
+    {
+        rtc.carry = true;
+        rtc.seconds %= RTC_MAX_SECONDS;
+    }
+}
+
+/* Function: static BYTE GetRTCRegister(BYTE reg, GBCPU & CPU)
+             Returns an RTC register as of the last update. */
+static BYTE GetRTCRegister(BYTE reg, GBCPU & CPU)
+{
+    rtc_clock & rtc = CPU.gb->mbc.mbc3_rtc;
+
+    unsigned long long days = rtc.seconds / RTC_DAY_SECONDS;
+
+    switch (reg)
+    {
+    case RTC_S:  return (BYTE)(rtc.seconds % 60);
+    case RTC_M:  return (BYTE)((rtc.seconds / 60) % 60);
+    case RTC_H:  return (BYTE)((rtc.seconds / (60 * 60)) % 24);
+    case RTC_DL: return (BYTE)(days & 0xFF);
+    default:     return (BYTE)(((days >> 8) & 0x01) | (rtc.halted ? 0x40 : 0x00) | (rtc.carry ? 0x80 : 0x00));
+    }
+}
+
+/* Function: static void SetRTCRegister(BYTE reg, BYTE data, GBCPU & CPU)
+             Sets an RTC register, as games do to set the clock. */
+static void SetRTCRegister(BYTE reg, BYTE data, GBCPU & CPU)
+{
+    rtc_clock & rtc = CPU.gb->mbc.mbc3_rtc;
+
+    UpdateRTC(CPU);
+
+    unsigned long long s = rtc.seconds % 60;
+    unsigned long long m = (rtc.seconds / 60) % 60;
+    unsigned long long h = (rtc.seconds / (60 * 60)) % 24;
+    unsigned long long days = rtc.seconds / RTC_DAY_SECONDS;
+
+    switch (reg)
+    {
+    case RTC_S:
+        s = data & 0x3F;
+
+        // Writing the seconds also restarts the current second
+        rtc.reference = GetRTCTime(CPU);
+        break;
+
+    case RTC_M:  m = data & 0x3F; break;
+    case RTC_H:  h = data & 0x1F; break;
+    case RTC_DL: days = (days & 0x100) | data; break;
+
+    default:
+        days = (days & 0xFF) | ((data & 0x01) << 8);
+        rtc.carry = (data & 0x80) != 0;
+
+        // Starting the clock again counts from now
+        if (rtc.halted && ((data & 0x40) == 0))
+            rtc.reference = GetRTCTime(CPU);
+
+        rtc.halted = (data & 0x40) != 0;
+        break;
+    }
+
+    rtc.seconds = days * RTC_DAY_SECONDS + h * 60 * 60 + m * 60 + s;
+}
+
+/* Function: static void LatchRTC(GBCPU & CPU)
+             Copies the clock into the registers the game reads. */
+static void LatchRTC(GBCPU & CPU)
+{
+    rtc_clock & rtc = CPU.gb->mbc.mbc3_rtc;
+
+    UpdateRTC(CPU);
+
+    for (BYTE reg = RTC_S; reg <= RTC_DH; ++reg)
+        rtc.latched[reg - RTC_S] = GetRTCRegister(reg, CPU);
+}
+
+/* Function: static void WriteRTCSave(GBCPU & CPU)
+             Stores the clock after external RAM in the .sav file, if there is one. */
+static void WriteRTCSave(GBCPU & CPU)
+{
+    rtc_clock & rtc = CPU.gb->mbc.mbc3_rtc;
+
+    BYTE * footer = GetSaveFooter(CPU);
+    if (footer == NULL)
+        return;
+
+    UpdateRTC(CPU);
+
+    unsigned int values[10];
+    for (BYTE reg = RTC_S; reg <= RTC_DH; ++reg)
+    {
+        values[reg - RTC_S] = GetRTCRegister(reg, CPU);
+        values[reg - RTC_S + 5] = rtc.latched[reg - RTC_S];
+    }
+
+    // Little endian, whatever the host
+    unsigned long long timestamp = (unsigned long long)time(NULL);
+    for (int i = 0; i < 40; ++i)
+        footer[i] = (BYTE)(values[i / 4] >> ((i % 4) * 8));
+    for (int i = 0; i < 8; ++i)
+        footer[40 + i] = (BYTE)(timestamp >> (i * 8));
+}
+
+/* Function: static void ReadRTCSave(GBCPU & CPU)
+             Restores the clock from the .sav file. With host time, the time
+             passed since the file was saved is added to the clock. */
+static void ReadRTCSave(GBCPU & CPU)
+{
+    rtc_clock & rtc = CPU.gb->mbc.mbc3_rtc;
+
+    memset(&rtc, 0, sizeof(rtc));
+    rtc.reference = GetRTCTime(CPU);
+
+    const BYTE * footer = GetSaveFooter(CPU);
+    if (footer == NULL)
+        return;
+
+    unsigned int values[10];
+    unsigned long long timestamp = 0;
+    for (int i = 0; i < 10; ++i)
+        values[i] = footer[i * 4] | (footer[i * 4 + 1] << 8) | (footer[i * 4 + 2] << 16) | ((unsigned int)footer[i * 4 + 3] << 24);
+    for (int i = 7; i >= 0; --i)
+        timestamp = (timestamp << 8) | footer[40 + i];
+
+    unsigned long long days = (values[3] & 0xFF) | ((values[4] & 0x01) << 8);
+    rtc.seconds = days * RTC_DAY_SECONDS + (values[2] & 0x1F) * 60 * 60 + (values[1] & 0x3F) * 60 + (values[0] & 0x3F);
+    rtc.halted = (values[4] & 0x40) != 0;
+    rtc.carry = (values[4] & 0x80) != 0;
+
+    for (int i = 0; i < 5; ++i)
+        rtc.latched[i] = (BYTE)values[i + 5];
+
+    // A new file has no timestamp
+    if (CPU.gb->mbc.rtc_host_time && (timestamp != 0))
+        rtc.reference = timestamp;
+}
+
+/* Function: static void MapMBC3RAM(GBCPU & CPU)
+             Maps the selected RAM bank, or nothing if an RTC register is selected. */
+static void MapMBC3RAM(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    MapRAMBank(mbc.mbc3_ram_bank, mbc.ram_bank_access_enabled && (mbc.mbc3_ram_bank <= 0x03), CPU);
+}
+
+/* Function: static void MBC3Reset(GBCPU & CPU)
+             Selects ROM bank #1 and RAM bank #0, with RAM disabled, and
+             restores the real-time clock. */
+static void MBC3Reset(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    mbc.mbc3_rom_bank = 1;
+    mbc.mbc3_ram_bank = 0;
+    mbc.ram_bank_access_enabled = false;
+
+    ReadRTCSave(CPU);
+
+    MapROMBank(mbc.mbc3_rom_bank, CPU);
+    MapMBC3RAM(CPU);
+}
+
+/* Function: static BYTE MBC3Read(WORD addr, GBCPU & CPU)
+             Reads the latched RTC register if one is selected. Disabled or
+             missing RAM reads as open bus. */
+static BYTE MBC3Read(WORD addr, GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    if (mbc.ram_bank_access_enabled && HasRTC(CPU.gb->cart.rom_mbc_type) && (mbc.mbc3_ram_bank >= RTC_S) && (mbc.mbc3_ram_bank <= RTC_DH))
+        return mbc.mbc3_rtc.latched[mbc.mbc3_ram_bank - RTC_S];
+
+    return 0xFF;
+}
+
+/* Function: static void MBC3Write(BYTE data, WORD addr, GBCPU & CPU)
+             Writes the MBC3 control registers, the selected RTC register, or
+             battery-backed RAM, which is only mapped for reads so that its
+             writes can be tracked. */
+static void MBC3Write(BYTE data, WORD addr, GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+    rtc_clock & rtc = mbc.mbc3_rtc;
+
+    // A write (XXXX 1010b) to $0000 - $1FFF enables external RAM and the RTC registers, anything else disables them
+    if (addr <= 0x1FFF)
+    {
+        bool enabled = ((data & 0x0F) == 0x0A);
+
+        // Games disable RAM once they are done saving, so write save RAM out now
+        if (mbc.ram_bank_access_enabled && (enabled == false))
+            FlushSaveRAM(CPU);
+
+        mbc.ram_bank_access_enabled = enabled;
+        MapMBC3RAM(CPU);
+    }
+
+    // $2000 - $3FFF selects the 7-bit ROM bank. Bank #0 selects bank #1 instead
+    else if (addr <= ROM_END)
+    {
+        mbc.mbc3_rom_bank = (data & 0x7F) ? (data & 0x7F) : 1;
+        MapROMBank(mbc.mbc3_rom_bank, CPU);
+    }
+
+    // $4000 - $5FFF selects the RAM bank ($00 - $03) or RTC register ($08 - $0C)
+    else if (addr <= 0x5FFF)
+    {
+        mbc.mbc3_ram_bank = data;
+        MapMBC3RAM(CPU);
+    }
+
+    // A write of $00 then $01 to $6000 - $7FFF latches the clock
+    else if (addr <= EXTERNAL_ROM_END)
+    {
+        if (HasRTC(CPU.gb->cart.rom_mbc_type) && (rtc.latch == 0x00) && (data == 0x01))
+        {
+            LatchRTC(CPU);
+            WriteRTCSave(CPU);
+        }
+
+        rtc.latch = data;
+    }
+
+    else if (mbc.ram_bank_access_enabled && (addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END))
+    {
+        // Setting the clock, which is saved right away
+        if (HasRTC(CPU.gb->cart.rom_mbc_type) && (mbc.mbc3_ram_bank >= RTC_S) && (mbc.mbc3_ram_bank <= RTC_DH))
+        {
+            SetRTCRegister(mbc.mbc3_ram_bank, data, CPU);
+            WriteRTCSave(CPU);
+            CPU.ext_ram_dirty = true;
+        }
+
+        // Battery-backed RAM, which is marked dirty for the next flush of the .sav file
+        else if (mbc.mbc3_ram_bank <= 0x03)
+        {
+            BYTE * ram = GetRAMAddress(mbc.mbc3_ram_bank, addr, CPU);
+
+            if (ram != NULL)
+            {
+                *ram = data;
+                CPU.ext_ram_dirty = true;
+            }
+        }
+    }
+}
+
+/* Function: static void MBC3Close(GBCPU & CPU)
+             Stores the clock as it is now in the .sav file. */
+static void MBC3Close(GBCPU & CPU)
+{
+    if (GetSaveFooter(CPU) == NULL)
+        return;
+
+    WriteRTCSave(CPU);
+    CPU.ext_ram_dirty = true;
+}
+
+void SetRTCHostTime(bool enabled, GBCPU & CPU)
+{
+    CPU.gb->mbc.rtc_host_time = enabled;
+
+    if (CPU.cart_mapper == &mbc3_mapper)
+        ReadRTCSave(CPU);
+}
+
+const mapper mbc3_mapper = { "MBC3", MBC3Reset, MBC3Read, MBC3Write, MBC3Close };
@@ -0,0 +1,115 @@
+/*  Name:        mbc5.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the MBC5 memory bank controller: up to 512
+                 ROM banks, up to 16 RAM banks and, on rumble cartridges, the
+                 rumble motor. Bank switches only remap the pages of
+                 $4000 - $7FFF and $A000 - $BFFF. */
+
+#include "mapper.h"
+#include "save_ram.h"
+#include "context.h"
+
+
+/* Function: static bool IsRumbleCartridge(GBCPU & CPU)
+             Returns true if the cartridge has a rumble motor, which takes over
+             bit 3 of the RAM bank register. */
+static bool IsRumbleCartridge(GBCPU & CPU)
+{
+    MBC_TYPES type = CPU.gb->cart.rom_mbc_type;
+
+    return (type == ROM_MBC5_RUMBLE) ||
+           (type == ROM_MBC5_RUMBLE_SRAM) ||
+           (type == ROM_MBC5_RUMBLE_SRAM_BATT);
+}
+
+/* Function: static void MBC5Reset(GBCPU & CPU)
+             Selects ROM bank #1 and RAM bank #0, with RAM disabled. */
+static void MBC5Reset(GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    mbc.mbc5_rom_bank = 1;
+    mbc.mbc5_ram_bank = 0;
+    mbc.mbc5_rumble = false;
+    mbc.ram_bank_access_enabled = false;
+
+    MapROMBank(mbc.mbc5_rom_bank, CPU);
+    MapRAMBank(mbc.mbc5_ram_bank, mbc.ram_bank_access_enabled, CPU);
+}
+
+/* Function: static BYTE MBC5Read(WORD addr, GBCPU & CPU)
+             Reads external RAM that isn't mapped. Disabled or missing RAM reads
+             as open bus. */
+static BYTE MBC5Read(WORD addr, GBCPU & CPU)
+{
+    return 0xFF;
+}
+
+/* Function: static void MBC5Write(BYTE data, WORD addr, GBCPU & CPU)
+             Writes the MBC5 control registers, or battery-backed RAM, which is
+             only mapped for reads so that its writes can be tracked. */
+static void MBC5Write(BYTE data, WORD addr, GBCPU & CPU)
+{
+    mapper_state & mbc = CPU.gb->mbc;
+
+    // A write (XXXX 1010b) to $0000 - $1FFF enables external RAM, anything else disables it
+    if (addr <= 0x1FFF)
+    {
+        bool enabled = ((data & 0x0F) == 0x0A);
+
+        // Games disable RAM once they are done saving, so write save RAM out now
+        if (mbc.ram_bank_access_enabled && (enabled == false))
+            FlushSaveRAM(CPU);
+
+        mbc.ram_bank_access_enabled = enabled;
+        MapRAMBank(mbc.mbc5_ram_bank, mbc.ram_bank_access_enabled, CPU);
+    }
+
+    // $2000 - $2FFF selects the lower 8 bits of the ROM bank. Unlike MBC1, bank #0 can be selected
+    else if (addr <= 0x2FFF)
+    {
+        mbc.mbc5_rom_bank = (mbc.mbc5_rom_bank & 0x100) | data;
+        MapROMBank(mbc.mbc5_rom_bank, CPU);
+    }
+
+    // $3000 - $3FFF selects bit 8 of the ROM bank
+    else if (addr <= ROM_END)
+    {
+        mbc.mbc5_rom_bank = (mbc.mbc5_rom_bank & 0xFF) | ((data & 0x01) << 8);
+        MapROMBank(mbc.mbc5_rom_bank, CPU);
+    }
+
+    // $4000 - $5FFF selects the RAM bank. On rumble cartridges bit 3 drives the motor instead
+    else if (addr <= 0x5FFF)
+    {
+        if (IsRumbleCartridge(CPU))
+        {
+            mbc.mbc5_rumble = (data & 0x08) != 0;
+            mbc.mbc5_ram_bank = data & 0x07;
+        }
+        else
+        {
+            mbc.mbc5_ram_bank = data & 0x0F;
+        }
+
+        MapRAMBank(mbc.mbc5_ram_bank, mbc.ram_bank_access_enabled, CPU);
+    }
+
+    // Battery-backed RAM, which is marked dirty for the next flush of the .sav file
+    else if ((addr >= EXTERNAL_RAM_START) && (addr <= EXTERNAL_RAM_END))
+    {
+        BYTE * ram = GetRAMAddress(mbc.mbc5_ram_bank, addr, CPU);
+
+        if (mbc.ram_bank_access_enabled && (ram != NULL))
+        {
+            *ram = data;
+            CPU.ext_ram_dirty = true;
+        }
+    }
+
+    // $6000 - $7FFF has no register on MBC5
+}
+
+const mapper mbc5_mapper = { "MBC5", MBC5Reset, MBC5Read, MBC5Write, NULL };
@@ -0,0 +1,281 @@
+/*  Name:        rom_image.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the registry of loaded ROM images. A ROM
+                 is mapped once per process and shared, read only, by every
+                 emulator instance running it. Only RAM, VRAM, OAM and I/O
+                 belong to each instance. */
+
+#include "rom_image.h"
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Loaded images by the file they were loaded from
+static map<rom_file_id, rom_image *> rom_images;
+static mutex rom_images_lock;
+
+
+/* Function: static bool operator<(const rom_file_id & a, const rom_file_id & b)
+             Orders file identities for the registry. */
+static bool operator<(const rom_file_id & a, const rom_file_id & b)
+{
+    if (a.device != b.device)
+        return a.device < b.device;
+    if (a.file != b.file)
+        return a.file < b.file;
+    if (a.size != b.size)
+        return a.size < b.size;
+
+    return a.modified < b.modified;
+}
+
+/* Function: static bool GetROMFileID(const string & rom_name, rom_file_id & id)
+             Gets the identity of a ROM file from its metadata alone. A file
+             that is replaced or changed gets a different identity. Returns
+             false if the file can't be found. */
+static bool GetROMFileID(const string & rom_name, rom_file_id & id)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(rom_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    BY_HANDLE_FILE_INFORMATION info;
+    bool found = (GetFileInformationByHandle(file, &info) != 0);
+    CloseHandle(file);
+
+    if (found == false)
+        return false;
+
+    id.device = info.dwVolumeSerialNumber;
+    id.file = ((unsigned long long)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+    id.size = ((unsigned long long)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    id.modified = ((long long)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat file_info;
+    if (stat(rom_name.c_str(), &file_info) != 0)
+        return false;
+
+    id.device = (unsigned long long)file_info.st_dev;
+    id.file = (unsigned long long)file_info.st_ino;
+    id.size = (unsigned long long)file_info.st_size;
+    id.modified = (long long)file_info.st_mtime;
+#endif
+
+    return true;
+}
+
+
+/* Function: static const BYTE * MapROMFile(const string & rom_name, size_t & size)
+             Maps a ROM file into memory, read only. Pages of the file are only
+             read from disk once they are touched, and processes mapping the
+             same file share them through the page cache. Returns NULL if the
+             file can't be mapped. */
+static const BYTE * MapROMFile(const string & rom_name, size_t & size)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(rom_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER file_size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &file_size) && (file_size.QuadPart > 0))
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL)
+        return NULL;
+
+    // The view keeps the mapping alive on its own
+    void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (data == NULL)
+        return NULL;
+
+    size = (size_t)file_size.QuadPart;
+#else
+    int file = open(rom_name.c_str(), O_RDONLY);
+    if (file < 0)
+        return NULL;
+
+    struct stat file_info;
+    if ((fstat(file, &file_info) != 0) || (file_info.st_size <= 0))
+    {
+        close(file);
+        return NULL;
+    }
+
+    // The mapping stays valid after the file is closed
+    void * data = mmap(NULL, file_info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (data == MAP_FAILED)
+        return NULL;
+
+    size = (size_t)file_info.st_size;
+#endif
+
+    return (const BYTE *)data;
+}
+
+/* Function: static const BYTE * ReadROMFile(const string & rom_name, size_t min_size, size_t & size)
+             Reads a whole ROM file into a heap copy of at least min_size
+             bytes, padded with zeros. Returns NULL if the file can't be read. */
+static const BYTE * ReadROMFile(const string & rom_name, size_t min_size, size_t & size)
+{
+    // Open at the end to get the file size. Specify read as binary. '1A' would cause EOF as text read.
+    ifstream file(rom_name, std::ios_base::binary | std::ios_base::ate);
+    if (file.good() != true)
+        return NULL;
+
+    size_t file_size = (size_t)file.tellg();
+    size = (file_size > min_size) ? file_size : min_size;
+
+    BYTE * data = (BYTE *)calloc(size, 1);
+    if (data == NULL)
+        return NULL;
+
+    file.seekg(0);
+    file.read((char *)data, file_size);
+
+    return data;
+}
+
+/* Function: static void FreeROMData(const BYTE * data, size_t size, bool mapped)
+             Releases ROM data, whichever way it was loaded. */
+static void FreeROMData(const BYTE * data, size_t size, bool mapped)
+{
+    if (data == NULL)
+        return;
+
+    if (mapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap((void *)data, size);
+#endif
+    }
+    else
+    {
+        free((void *)data);
+    }
+}
+
+/* Function: static size_t GetHeaderROMSize(const BYTE * data)
+             Returns the ROM size given by the cartridge header at $148, or 0
+             if it isn't a known size. */
+static size_t GetHeaderROMSize(const BYTE * data)
+{
+    BYTE code = data[0x148];
+
+    // 32 KByte << code, or one of the odd sizes given as a number of 16 KByte banks
+    if (code <= 0x08)
+        return (32 * 1024) << code;
+    else if (code == 0x52)
+        return 72 * 16 * 1024;
+    else if (code == 0x53)
+        return 80 * 16 * 1024;
+    else if (code == 0x54)
+        return 96 * 16 * 1024;
+
+    return 0;
+}
+
+rom_image * AcquireROMImage(const string & rom_name)
+{
+    rom_file_id id;
+    if (GetROMFileID(rom_name, id) == false)
+        return NULL;
+
+    // Share the image of the file if it is already loaded. The lock is held while loading, so two
+    // instances starting the same game at once don't both load it
+    lock_guard<mutex> lock(rom_images_lock);
+
+    auto found = rom_images.find(id);
+    if (found != rom_images.end())
+    {
+        ++found->second->references;
+        return found->second;
+    }
+
+    size_t size = 0;
+    const BYTE * data = MapROMFile(rom_name, size);
+    bool mapped = true;
+
+    // ROM banks #0 and #1 must both be there to be mapped into memory, along with every bank in the header.
+    // Otherwise, or if the file can't be mapped, a copy padded with zeros is read instead
+    if ((data == NULL) || (size <= EXTERNAL_ROM_END) || (size < GetHeaderROMSize(data)))
+    {
+        FreeROMData(data, size, mapped);
+        data = ReadROMFile(rom_name, EXTERNAL_ROM_END + 1, size);
+        mapped = false;
+
+        if (data == NULL)
+            return NULL;
+
+        size_t header_size = GetHeaderROMSize(data);
+        if (size < header_size)
+        {
+            BYTE * padded = (BYTE *)realloc((void *)data, header_size);
+            if (padded == NULL)
+            {
+                FreeROMData(data, size, mapped);
+                return NULL;
+            }
+
+            memset(&padded[size], 0, header_size - size);
+            data = padded;
+            size = header_size;
+        }
+    }
+
+    rom_image * image = new rom_image;
+    image->data = data;
+    image->size = size;
+    image->mapped = mapped;
+    image->id = id;
+    image->references = 1;
+
+    rom_images[id] = image;
+
+    return image;
+}
+
+void ReleaseROMImage(rom_image * image)
+{
+    if (image == NULL)
+        return;
+
+    lock_guard<mutex> lock(rom_images_lock);
+
+    if (--image->references > 0)
+        return;
+
+    rom_images.erase(image->id);
+
+    FreeROMData(image->data, image->size, image->mapped);
+    delete image;
+}
+
+size_t GetROMImageCount()
+{
+    lock_guard<mutex> lock(rom_images_lock);
+
+    return rom_images.size();
+}
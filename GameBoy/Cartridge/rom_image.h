@@ -0,0 +1,41 @@
+#ifndef ROM_IMAGE_H
+#define ROM_IMAGE_H
+
+#include "gameboy.h"
+#include <string>
+
+using namespace std;
+
+// Identifies a ROM file, and the version of it, without reading its contents
+typedef struct rom_file_id
+{
+    unsigned long long device;    // Device (or volume serial number) the file is on
+    unsigned long long file;      // Inode (or file index) of the file on its device
+    unsigned long long size;      // Size of the file in bytes
+    long long modified;           // Last modification time of the file
+} rom_file_id;
+
+// A read-only ROM, shared by every emulator instance running the same game.
+// Images are kept in a registry keyed by the identity of the file they were
+// loaded from, so loading a ROM that is already loaded only adds a reference
+// to it, without reading any of the file.
+typedef struct rom_image
+{
+    const BYTE * data;        // The whole ROM, mapped read-only from its file or a heap copy padded with zeros
+    size_t size;              // Size of data in bytes. At least ROM banks #0 and #1, and at least the size in the header
+    bool mapped;              // data is a file mapping rather than a heap copy
+    rom_file_id id;           // The file the image was loaded from, which it is registered under
+    unsigned int references;  // Number of emulator instances using the image
+} rom_image;
+
+// Returns the image of a ROM file, adding a reference to its image if the same file is already loaded.
+// Returns NULL if the file can't be read
+rom_image * AcquireROMImage(const string & rom_name);
+
+// Drops a reference to an image, releasing it once no emulator instance uses it
+void ReleaseROMImage(rom_image * image);
+
+// Returns the number of distinct images loaded
+size_t GetROMImageCount();
+
+#endif /* rom_image.h */
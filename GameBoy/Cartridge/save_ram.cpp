@@ -0,0 +1,272 @@
+/*  Name:        save_ram.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the battery-backed save RAM of a cartridge.
+                 External RAM is mapped straight from a .sav file next to the
+                 ROM, marked dirty by the RAM write path, and flushed to disk
+                 every so often or when the game disables RAM. */
+
+#include "save_ram.h"
+#include "context.h"
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// Define save RAM variables
+unsigned int save_flush_interval = 1;
+
+
+/* Function: static BYTE * MapSaveFile(const string & path, size_t size, intptr_t & handle, bool & in_use)
+             Maps a .sav file for reading and writing, growing it to size bytes
+             (with zeros) if it is shorter. The file is kept open and locked in
+             handle until it is unmapped. Returns NULL if it can't be mapped, with
+             in_use set if that is because another instance holds its lock. */
+static BYTE * MapSaveFile(const string & path, size_t size, intptr_t & handle, bool & in_use)
+{
+    in_use = false;
+
+#ifdef _WIN32
+    // Other instances may read the file, but not open it for writing while it is mapped here
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        in_use = (GetLastError() == ERROR_SHARING_VIOLATION);
+        return NULL;
+    }
+
+    // A mapping larger than the file grows the file
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, (DWORD)size, NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    void * data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    CloseHandle(mapping);
+
+    if (data == NULL)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    handle = (intptr_t)file;
+    return (BYTE *)data;
+#else
+    int file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0)
+        return NULL;
+
+    // flock locks belong to the open file, so this also keeps out other instances in the same process
+    if (flock(file, LOCK_EX | LOCK_NB) != 0)
+    {
+        in_use = (errno == EWOULDBLOCK);
+        close(file);
+        return NULL;
+    }
+
+    struct stat file_info;
+    if ((fstat(file, &file_info) != 0) ||
+        (((size_t)file_info.st_size < size) && (ftruncate(file, size) != 0)))
+    {
+        close(file);
+        return NULL;
+    }
+
+    void * data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (data == MAP_FAILED)
+    {
+        close(file);
+        return NULL;
+    }
+
+    handle = file;
+    return (BYTE *)data;
+#endif
+}
+
+/* Function: static void UnmapSaveFile(BYTE * data, size_t size, intptr_t handle)
+             Writes a mapped .sav file out to disk, unmaps it and releases its lock. */
+static void UnmapSaveFile(BYTE * data, size_t size, intptr_t handle)
+{
+#ifdef _WIN32
+    FlushViewOfFile(data, size);
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)handle);
+#else
+    msync(data, size, MS_SYNC);
+    munmap(data, size);
+    close((int)handle);
+#endif
+}
+
+bool HasBattery(MBC_TYPES type)
+{
+    switch (type)
+    {
+    case ROM_MBC1_RAM_BATT:
+    case ROM_MBC2_BATT:
+    case ROM_RAM_BATT:
+    case ROM_MM01_SRAM_BATT:
+    case ROM_MBC3_TIMER_BATT:
+    case ROM_MBC3_TIMER_RAM_BATT:
+    case ROM_MBC3_RAM_BATT:
+    case ROM_MBC5_RAM_BATT:
+    case ROM_MBC5_RUMBLE_SRAM_BATT:
+    case HUDSON_HUC_3:
+    case HUDSON_HUC_1:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+string GetSavePath(const string & rom_name)
+{
+    // Replace the ROM's extension, if it has one
+    size_t dot = rom_name.find_last_of('.');
+    size_t slash = rom_name.find_last_of("/\\");
+
+    if ((dot == string::npos) || ((slash != string::npos) && (dot < slash)))
+        return rom_name + ".sav";
+
+    return rom_name.substr(0, dot) + ".sav";
+}
+
+bool OpenSaveRAM(const string & path, size_t footer_size, GBCPU & CPU)
+{
+    CloseSaveRAM(CPU);
+
+    save_file * save = new save_file;
+    save->path = path;
+    save->size = CPU.gb->cart.ext_ram_size + footer_size;
+    save->footer_size = footer_size;
+    save->last_flush = CPU.cycle_count;
+    save->handle = 0;
+
+    bool in_use;
+    BYTE * data = MapSaveFile(path, save->size, save->handle, in_use);
+    save->mapped = (data != NULL);
+    save->owned = (in_use == false);
+
+    if (save->mapped)
+    {
+        free(CPU.ext_ram);
+        CPU.ext_ram = data;
+    }
+    else
+    {
+        // Keep the heap copy, loaded from the file if there is one, and write all of it out on each flush
+        ifstream file(path, std::ios_base::binary);
+
+        // The first instance to open the file saves to it. This one plays on from a copy of it
+        if (in_use)
+            printf("Save file %s is in use by another instance, this one will not be saved\n", path.c_str());
+
+        else if (ofstream(path, std::ios_base::binary | std::ios_base::app).good() != true)
+        {
+            printf("Could not open save file %s, the game will not be saved\n", path.c_str());
+            delete save;
+            return false;
+        }
+
+        // Make room for the footer
+        if (footer_size > 0)
+        {
+            BYTE * ram = (BYTE *)realloc(CPU.ext_ram, save->size);
+            if (ram == NULL)
+            {
+                printf("Could not load save file %s, the game will not be saved\n", path.c_str());
+                delete save;
+                return false;
+            }
+
+            CPU.ext_ram = ram;
+            memset(&CPU.ext_ram[CPU.gb->cart.ext_ram_size], 0, footer_size);
+        }
+
+        if (file.good())
+            file.read((char *)CPU.ext_ram, save->size);
+    }
+
+    CPU.save = save;
+    CPU.ext_ram_dirty = false;
+
+    return true;
+}
+
+BYTE * GetSaveFooter(GBCPU & CPU)
+{
+    if ((CPU.save == NULL) || (CPU.save->footer_size == 0))
+        return NULL;
+
+    return &CPU.ext_ram[CPU.gb->cart.ext_ram_size];
+}
+
+void FlushSaveRAM(GBCPU & CPU)
+{
+    save_file * save = CPU.save;
+    if ((save == NULL) || (CPU.ext_ram_dirty == false))
+        return;
+
+    // Mapped RAM is already in the file, so only ask the OS to start writing it to disk
+    if (save->mapped)
+    {
+#ifdef _WIN32
+        FlushViewOfFile(CPU.ext_ram, save->size);
+#else
+        msync(CPU.ext_ram, save->size, MS_ASYNC);
+#endif
+    }
+
+    // A heap copy is written out whole, unless it is a copy of a file another instance saves to
+    else if (save->owned)
+    {
+        ofstream file(save->path, std::ios_base::binary | std::ios_base::trunc);
+        file.write((const char *)CPU.ext_ram, save->size);
+    }
+
+    CPU.ext_ram_dirty = false;
+    save->last_flush = CPU.cycle_count;
+}
+
+void UpdateSaveRAM(GBCPU & CPU)
+{
+    if ((CPU.save == NULL) || (CPU.ext_ram_dirty == false) || (save_flush_interval == 0))
+        return;
+
+    if (CPU.cycle_count - CPU.save->last_flush >= (unsigned long long)save_flush_interval * SAVE_CYCLES_PER_SECOND)
+        FlushSaveRAM(CPU);
+}
+
+void CloseSaveRAM(GBCPU & CPU)
+{
+    save_file * save = CPU.save;
+    if (save == NULL)
+        return;
+
+    FlushSaveRAM(CPU);
+
+    if (save->mapped)
+    {
+        UnmapSaveFile(CPU.ext_ram, save->size, save->handle);
+        CPU.ext_ram = NULL;
+    }
+
+    delete save;
+    CPU.save = NULL;
+}
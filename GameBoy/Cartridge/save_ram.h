@@ -0,0 +1,57 @@
+#ifndef SAVE_RAM_H
+#define SAVE_RAM_H
+
+#include "GBCPU.h"
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Number of cycles (as counted by GBCPU::cycle_count) in a second of emulated time
+#define SAVE_CYCLES_PER_SECOND 4194304
+
+// The .sav file behind a battery-backed cartridge's external RAM. The RAM is
+// a shared mapping of the file, so writes land in the file without any I/O
+// on the CPU thread, and survive the emulator crashing. Flushing only asks
+// the OS to write the pages out to disk. The mapping holds an exclusive lock
+// on the file, so only one instance of a game saves to it; any other
+// instance runs on a private copy that is never written back.
+typedef struct save_file
+{
+    string path;                    // The .sav file
+    size_t size;                    // Bytes kept in the file: external RAM followed by the footer
+    size_t footer_size;             // Bytes of cartridge state (such as a real-time clock) kept after external RAM
+    bool mapped;                    // ext_ram is a mapping of the file. Otherwise it is a heap copy written out on each flush
+    bool owned;                     // This instance saves to the file. False if another instance holds it
+    intptr_t handle;                // The open, locked file while it is mapped
+    unsigned long long last_flush;  // CPU cycle_count at the last flush
+} save_file;
+
+/* Save RAM state (save_ram.cpp) */
+extern unsigned int save_flush_interval; // Seconds of emulated time between flushes of written save RAM. 0 = only when RAM is disabled and on exit
+
+// Returns true if the cartridge type keeps its external RAM alive with a battery
+bool HasBattery(MBC_TYPES type);
+
+// Returns the path of the .sav file kept next to a ROM file
+string GetSavePath(const string & rom_name);
+
+// Replaces the CPU's external RAM with the contents of a .sav file, which is created if it doesn't exist.
+// The file holds footer_size more bytes after external RAM for other cartridge state. If another instance
+// already has the file open, this one gets a copy of it and its own writes are not saved.
+// Returns false if the file can't be opened, leaving external RAM as it was and unsaved
+bool OpenSaveRAM(const string & path, size_t footer_size, GBCPU & CPU);
+
+// Returns the footer kept after external RAM in the .sav file, or NULL if there is none
+BYTE * GetSaveFooter(GBCPU & CPU);
+
+// Writes external RAM out to its .sav file if it was written since the last flush
+void FlushSaveRAM(GBCPU & CPU);
+
+// Called once per frame: flushes external RAM if it was written and the flush interval has passed
+void UpdateSaveRAM(GBCPU & CPU);
+
+// Flushes external RAM to its .sav file and closes it. The CPU is left without external RAM
+void CloseSaveRAM(GBCPU & CPU);
+
+#endif /* save_ram.h */
@@ -7,12 +7,11 @@
                  to determine when keys have been pressed/released. */
 
 #include "joypad.h"
+#include "context.h"
 
 // Define variables used for joypad logic
 const Uint8 *SDL_GB_keyboard_state;
 SDL_Event SDL_GB_window_event;
-BYTE GB_buttons = 0x0F;
-BYTE GB_dpad = 0x0F;
 
 
 /* Function: bool ProcessSDLEvents(SDL_Event & SDL_GB_window_event, GBCPU & CPU)
@@ -93,18 +92,18 @@ void SetJoypadKey(GBCPU & CPU, BYTE enable_bit, BYTE key_bit)
 
     // Set keys (0 means set)
     if (enable_bit == P1_DPAD)
-        GB_dpad &= (~key_bit);
+        CPU.gb->joypad.dpad &= (~key_bit);
 
     else if (enable_bit == P1_BUTTONS)
-        GB_buttons &= (~key_bit);
+        CPU.gb->joypad.buttons &= (~key_bit);
 }
 
 void ResetJoypadKey(GBCPU & CPU, BYTE enable_bit, BYTE key_bit)
 {
     // Reset keys(1 means not set)
     if (enable_bit == P1_DPAD)
-        GB_dpad |= key_bit;
+        CPU.gb->joypad.dpad |= key_bit;
 
     else if (enable_bit == P1_BUTTONS)
-        GB_buttons |= key_bit;
+        CPU.gb->joypad.buttons |= key_bit;
 }
\ No newline at end of file
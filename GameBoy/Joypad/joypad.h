@@ -3,6 +3,13 @@
 
 #include "GBCPU.h"
 
+// Keys currently held down. A cleared bit is a pressed key, as JOYPAD_P1 reads them
+typedef struct joypad_state
+{
+    BYTE buttons;   // Packs the currently pressed button keys
+    BYTE dpad;      // Packs the currently pressed dpad keys
+} joypad_state;
+
 // Process Inputs from SDL events
 bool ProcessSDLEvents(SDL_Event &event, GBCPU & CPU);
 
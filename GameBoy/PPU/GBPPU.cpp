@@ -6,10 +6,58 @@
                  tiles for the GameBoy Picture Processing Unit. */
 
 #include "GBPPU.h"
+#include "render_thread.h"
+#include "deferred_render.h"
+#include "dirty_lines.h"
+#include "frame_skip.h"
+#include "pixel_fifo.h"
+#include "recorder.h"
+#include "framebuffer.h"
+#include "frame_capture.h"
+#include "context.h"
+
+
+/* Function: void InitPPU(GBCPU & CPU)
+             Puts the PPU at the start of a frame and builds the sprite index
+             and background layer cache from the current contents of video
+             memory. Called once after loading a ROM. */
+void InitPPU(GBCPU & CPU)
+{
+    ppu_state & ppu = CPU.gb->PPU;
+
+    ppu.scanline_counter = 0;
+    ppu.frame_count = 0;
+    ppu.window.wy_triggered = false;
+    ppu.window.line = 0;
+    ResetOAMIndex(ppu.sprite_index, &CPU.MEM[SPRITE_TABLE_START]);
+    ResetBackgroundCache(ppu.bg_cache);
+    ppu.lcd_enabled = (CPU.MEM[LCDC] & 0x80) ? true : false;
+}
 
-// Counter that keeps track of the number of cycles occured to increment the next scanline
-unsigned short scanline_counter = 0;
+/* Function: void WriteLCDControl(BYTE data, GBCPU & CPU)
+             Handles a write to LCDC. Turning the LCD off puts the PPU at rest
+             (LY 0, STAT mode reset) once and suspends it, so nothing runs per
+             instruction until the LCD is turned back on. */
+void WriteLCDControl(BYTE data, GBCPU & CPU)
+{
+    bool was_enabled = (CPU.MEM[LCDC] & 0x80) ? true : false;
+    CPU.MEM[LCDC] = data;
 
+    if (data & 0x80)
+    {
+        CPU.gb->PPU.lcd_enabled = true;
+    }
+    else if (was_enabled)
+    {
+        // Both engines reset their LCD status when they see the LCD off
+        if (CPU.gb->PPU.engine == PPU_ENGINE_FIFO)
+            ExecutePixelFIFO(0, CPU);
+        else
+            UpdateLCDStatus(CPU);
+
+        CPU.gb->PPU.lcd_enabled = false;
+    }
+}
 
 /* Function: void ExecutePPU(BYTE cycles, GBCPU & CPU)
              Executes picture processor unit functionality by
@@ -17,23 +65,33 @@ unsigned short scanline_counter = 0;
              currently passed since the last opcode executed. */
 void ExecutePPU(BYTE cycles, GBCPU & CPU)
 {
+    ppu_state & ppu = CPU.gb->PPU;
+
     /* TODO: Optimize ExecutePPU
              1) Create macros from cycles per scanline and register masks
              2) 
 
              */
     // We render 60 frames per second, therefore we need 4.194304 Mhz / 60 / 153 = 456 cycles per scaneline
+
+    // Nothing to do while the LCD is off. WriteLCDControl already left LY and STAT at rest
+    if (ppu.lcd_enabled == false)
+        return;
+
+    // The pixel FIFO engine keeps its own LCD status and draws pixels as it goes
+    if (CPU.gb->PPU.engine == PPU_ENGINE_FIFO)
+    {
+        ExecutePixelFIFO(cycles, CPU);
+        return;
+    }
     
     // Check and Update the status of the LCD through the LCD STAT register
     UpdateLCDStatus(CPU);
 
-    // Only render scanlines if the LCD Display is enabled
-    if (CPU.readByte(LCDC) & 0x80)
-        scanline_counter += cycles;
-    else
-        return;
+    // Scanlines are only rendered while the LCD Display is enabled, which ppu.lcd_enabled guarantees
+    ppu.scanline_counter += cycles;
 
-    if (scanline_counter >= 456)
+    if (ppu.scanline_counter >= 456)
     {
         if (CPU.readByte(PPU_LY) > VBLANK_END)
         {
@@ -44,12 +102,20 @@ void ExecutePPU(BYTE cycles, GBCPU & CPU)
         {
             // Set V-Blank interrupt if we're at LY = 144
             CPU.writeByte(CPU.readByte(INTERRUPT_FLAG) | 0x01, INTERRUPT_FLAG);
+
+            // Draw the whole frame now if scanlines were only logged
+            if (CPU.gb->deferred != NULL)
+                RenderDeferredFrame(CPU);
+
+            FinishFrame(CPU);
+
             ++CPU.MEM[PPU_LY]; // write directly to avoid resetting to 0 thru writeByte function.
         }
         else if (CPU.readByte(PPU_LY) < VBLANK_START)
         {
-            // Render scanline if we're within range
-            RenderScanline(CPU);
+            // Render scanline if we're within range, unless this frame is skipped
+            if (IsFrameSkipped(CPU) == false)
+                RenderScanline(CPU);
             ++CPU.MEM[PPU_LY]; // write directly to avoid resetting to 0 thru writeByte function.
         }
         else
@@ -60,7 +126,7 @@ void ExecutePPU(BYTE cycles, GBCPU & CPU)
 
         // We increment scanlines in each if branch because incrementing it here was skipping scanline 0 
         // Reset scanline cycles counter
-        scanline_counter -= 456;
+        ppu.scanline_counter -= 456;
     }
 
 
@@ -69,10 +135,12 @@ void ExecutePPU(BYTE cycles, GBCPU & CPU)
 
 void UpdateLCDStatus(GBCPU & CPU)
 {
+    ppu_state & ppu = CPU.gb->PPU;
+
     // Reset flags if the LCD is disabled
     if ((CPU.MEM[LCDC] & 0x80) == 0x00)
     {
-        scanline_counter = 0; // Reset Scanline cycles counter
+        ppu.scanline_counter = 0; // Reset Scanline cycles counter
         CPU.MEM[PPU_LY] = 0;  // Reset Y-Coordinate
         CPU.MEM[STAT] = ((CPU.MEM[STAT] & 0xFC) | 0x01); // Set mode to V-Blank
 
@@ -102,7 +170,7 @@ void UpdateLCDStatus(GBCPU & CPU)
     else
     {
         // Mode 2 - OAM Period [happens between 77-83 clocks per 465 clocks]
-        if (scanline_counter >= 80)
+        if (ppu.scanline_counter >= 80)
         {
             // Set current mode
             CPU.MEM[STAT] = (CPU.MEM[STAT] & 0xFC) | 2;
@@ -112,7 +180,7 @@ void UpdateLCDStatus(GBCPU & CPU)
         }
 
         // Mode 3 - OAM/VRAM (data xfer to LCD) Period [happens between 169-175 clocks per 456 clocks]
-        if (scanline_counter >= 172)
+        if (ppu.scanline_counter >= 172)
         {
             // Set current mode
             CPU.MEM[STAT] = (CPU.MEM[STAT] & 0xFC) | 3;
@@ -153,7 +221,173 @@ void UpdateLCDStatus(GBCPU & CPU)
     }
 }
 
+/* Function: void FinishFrame(GBCPU & CPU)
+             Called by either PPU engine when a frame is complete, as LY
+             reaches 144 and V-Blank starts. */
+void FinishFrame(GBCPU & CPU)
+{
+    // Pipelined scanlines have to land in the framebuffer before the frame is looked at
+    if (recorder_enabled || IsFrameCaptureActive())
+        FlushRenderThread(CPU);
+
+    // Hand the frame to the recorder. A frame that was skipped or left unchanged repeats the last recorded one,
+    // so the video keeps its frame rate without converting the same pixels again
+    bool changed = IsFrameChanged(CPU);
+    if (recorder_enabled && (changed || (RecordRepeatedFrame() == false)))
+    {
+        if (framebuffer_format == FRAMEBUFFER_INDEXED)
+            RecordIndexedFrame(CPU.gb->frame.index_buffer);
+        else
+            RecordFrame(CPU.gb->frame.pixel_buffer);
+    }
+
+    // Count the frame, and hash it or take a screenshot if asked to
+    CaptureFrame(CPU.gb->frame, CPU.gb->PPU.frame_count++);
+
+    // Decide whether the next frame is drawn at all
+    AdvanceFrameSkip(CPU);
+}
+
+/* Function: void WriteVideoMemory(WORD addr, BYTE data, GBCPU & CPU)
+             Writes a byte to VRAM or OAM. Every CPU write to video memory goes
+             through here so that any renderer holding its own copy of video
+             memory sees the write in order with the scanlines. */
+void WriteVideoMemory(WORD addr, BYTE data, GBCPU & CPU)
+{
+    if (CPU.gb->deferred != NULL)
+        LogVideoWrite(addr, CPU);
+
+    if (CPU.MEM[addr] != data)
+    {
+        MarkVideoMemoryDirty(CPU);
+        if (addr < SPRITE_TABLE_START)
+            UpdateBackgroundCache(CPU.gb->PPU.bg_cache, addr);
+    }
+
+    CPU.MEM[addr] = data;
+
+    if (addr >= SPRITE_TABLE_START)
+        UpdateOAMIndex(CPU.gb->PPU.sprite_index, addr, data);
+
+    if (CPU.gb->render_thread != NULL)
+        QueueVideoWrite(addr, data, CPU);
+}
+
+/* Function: void WriteSpriteTable(const BYTE * data, GBCPU & CPU)
+             Writes all of OAM at once, as an OAM DMA transfer does. The sprite
+             index is rebuilt once instead of being updated per byte. */
+void WriteSpriteTable(const BYTE * data, GBCPU & CPU)
+{
+    BYTE * oam = &CPU.MEM[SPRITE_TABLE_START];
+    const WORD size = SPRITE_TABLE_END - SPRITE_TABLE_START + 1;
+
+    // Renderers with their own copy of video memory take the changed bytes one by one, in order with their scanlines
+    if ((CPU.gb->deferred != NULL) || (CPU.gb->render_thread != NULL))
+    {
+        for (WORD i = 0; i < size; ++i)
+        {
+            if (oam[i] != data[i])
+                WriteVideoMemory(SPRITE_TABLE_START + i, data[i], CPU);
+        }
+        return;
+    }
+
+    if (memcmp(oam, data, size) == 0)
+        return;
+
+    MarkVideoMemoryDirty(CPU);
+    memcpy(oam, data, size);
+    ResetOAMIndex(CPU.gb->PPU.sprite_index, oam);
+}
+
+/* Function: void RenderScanline(GBCPU & CPU)
+             Captures the PPU registers for the current scanline and renders
+             it, either in place or by queueing it for the render thread. */
 void RenderScanline(GBCPU & CPU)
+{
+    ppu_line_registers regs = GetLineRegisters(CPU);
+    regs.window_line = NextWindowLine(CPU.gb->PPU.window, regs);
+
+    // Nothing to do if the pixel buffer already holds this line as it would be drawn now
+    if (IsScanlineDirty(regs, CPU) == false)
+        return;
+
+    // Pipelined mode: the render thread draws the line from its own copy of video memory
+    if (CPU.gb->render_thread != NULL)
+    {
+        QueueScanline(regs, CPU);
+        return;
+    }
+
+    // Deferred mode: the line is drawn with the rest of the frame at V-Blank
+    if (CPU.gb->deferred != NULL)
+    {
+        LogScanline(regs, CPU);
+        return;
+    }
+
+    RenderScanline(regs, GetVideoMemory(CPU));
+}
+
+/* Function: ppu_line_registers GetLineRegisters(GBCPU & CPU)
+             Takes a snapshot of the registers used to render the current scanline. */
+ppu_line_registers GetLineRegisters(GBCPU & CPU)
+{
+    ppu_line_registers regs;
+    regs.lcdc = CPU.MEM[LCDC];
+    regs.scx  = CPU.MEM[PPU_SCROLLX];
+    regs.scy  = CPU.MEM[PPU_SCROLLY];
+    regs.wx   = CPU.MEM[PPU_WX];
+    regs.wy   = CPU.MEM[PPU_WY];
+    regs.bgp  = CPU.MEM[PPU_BGP];
+    regs.obp0 = CPU.MEM[PPU_OBP0];
+    regs.obp1 = CPU.MEM[PPU_OBP1];
+    regs.ly   = CPU.MEM[PPU_LY];
+    regs.window_line = WINDOW_LINE_NONE;
+
+    return regs;
+}
+
+/* Function: BYTE NextWindowLine(ppu_window_state & window, const ppu_line_registers & regs)
+             Steps the window through the frame for the scanline about to be
+             drawn and returns the window row it shows, or WINDOW_LINE_NONE.
+             The window starts once LY has matched WY in this frame and then
+             draws its rows in order on each line where it is enabled and on
+             screen, so lines with the window hidden don't skip any rows. */
+BYTE NextWindowLine(ppu_window_state & window, const ppu_line_registers & regs)
+{
+    if (regs.ly == 0)
+    {
+        window.wy_triggered = false;
+        window.line = 0;
+    }
+
+    if (regs.ly == regs.wy)
+        window.wy_triggered = true;
+
+    bool window_shown = window.wy_triggered && (regs.lcdc & 0x20) && (regs.wx <= WINDOW_X_MAX);
+    if (window_shown == false)
+        return WINDOW_LINE_NONE;
+
+    return window.line++;
+}
+
+/* Function: ppu_video_memory GetVideoMemory(GBCPU & CPU)
+             Returns a view of VRAM and OAM as currently held in CPU memory,
+             drawing into the instance's framebuffer. */
+ppu_video_memory GetVideoMemory(GBCPU & CPU)
+{
+    ppu_video_memory mem;
+    mem.vram = &CPU.MEM[VRAM_START];
+    mem.oam  = &CPU.MEM[SPRITE_TABLE_START];
+    mem.sprites = &CPU.gb->PPU.sprite_index;
+    mem.layers  = &CPU.gb->PPU.bg_cache;
+    mem.frame   = &CPU.gb->frame;
+
+    return mem;
+}
+
+void RenderScanline(const ppu_line_registers & regs, const ppu_video_memory & mem)
 {
     /*
     Tile Data is stored in VRAM at addresses 8000h-97FFh, this area defines the Bitmaps for 192 Tiles. In CGB Mode 384 Tiles can be defined, because memory at 0:8000h-97FFh and at 1:8000h-97FFh is used.
@@ -170,16 +404,16 @@ void RenderScanline(GBCPU & CPU)
     */
 
     // Get LCD Control flags      
-    bool bg_tile_data = (CPU.MEM[LCDC] & 0x10) ? true : false; // 1 = 8000-8FFF, 0 = 8800-97FF. Location of data bytes. NOTE: if using 8800-97FF, used signed btyes
+    bool bg_tile_data = (regs.lcdc & 0x10) ? true : false; // 1 = 8000-8FFF, 0 = 8800-97FF. Location of data bytes. NOTE: if using 8800-97FF, used signed btyes
     WORD data_addr = (bg_tile_data ? 0x8000 : 0x8800);
 
     // Render the Tiles if enabled
-    bool bg_disp_en = (CPU.MEM[LCDC] & 0x01) ? true : false; // BG becomes white for GameBoy. Differs for SGB/GBC
+    bool bg_disp_en = (regs.lcdc & 0x01) ? true : false; // BG becomes white for GameBoy. Differs for SGB/GBC
     if (bg_disp_en)
     {
-        bool bg_map_used = (CPU.MEM[LCDC] & 0x08) ? true : false; // 1 = 9C00-9FFF, 0 = 9800-9BFF. Location of BG tile #s to use
+        bool bg_map_used = (regs.lcdc & 0x08) ? true : false; // 1 = 9C00-9FFF, 0 = 9800-9BFF. Location of BG tile #s to use
         WORD tile_addr = (bg_map_used ? 0x9C00 : 0x9800);
-        RenderTile(tile_addr, data_addr, CPU);
+        RenderTile(tile_addr, data_addr, regs, mem);
     }
     else
     {
@@ -187,12 +421,12 @@ void RenderScanline(GBCPU & CPU)
     }
 
     // Render the Window if enabled
-    bool window_display_en = (CPU.MEM[LCDC] & 0x20) ? true : false;
+    bool window_display_en = (regs.lcdc & 0x20) ? true : false;
     if( window_display_en )
     {
-        bool window_map_used = (CPU.MEM[LCDC] & 0x40) ? true : false; // 1 = 9C00-9FFF, 0 = 9800-9BFF. Location of Window tile #s to use    
+        bool window_map_used = (regs.lcdc & 0x40) ? true : false; // 1 = 9C00-9FFF, 0 = 9800-9BFF. Location of Window tile #s to use    
         WORD win_addr = (window_map_used ? 0x9C00 : 0x9800);
-        RenderWindow(win_addr, data_addr, CPU);
+        RenderWindow(win_addr, data_addr, regs, mem);
     }
     else
     {
@@ -200,11 +434,11 @@ void RenderScanline(GBCPU & CPU)
     }
 
     // Render the Sprites if enabled
-    bool sprite_disp_en = (CPU.MEM[LCDC] & 0x02) ? true : false;
+    bool sprite_disp_en = (regs.lcdc & 0x02) ? true : false;
     if (sprite_disp_en)
     {
-        bool use_8x16_sprite = (CPU.MEM[LCDC] & 0x04) ? true : false;
-        RenderSprite(CPU, use_8x16_sprite);
+        bool use_8x16_sprite = (regs.lcdc & 0x04) ? true : false;
+        RenderSprite(use_8x16_sprite, regs, mem);
     }
     else
     {
@@ -213,176 +447,161 @@ void RenderScanline(GBCPU & CPU)
 
 }
 
-void RenderTile(WORD loc_addr, WORD data_addr, GBCPU & CPU)
+/* Function: static void DrawMapLine(WORD loc_addr, WORD data_addr, BYTE map_x, BYTE map_y, int screen_x, BYTE scanline, const ppu_video_memory & mem)
+             Draws row map_y of a 256x256 tile map, starting at column map_x
+             and wrapping around at 256, from screen_x to the right edge of the
+             scanline. Used for both the background and the window. */
+static void DrawMapLine(WORD loc_addr, WORD data_addr, BYTE map_x, BYTE map_y, int screen_x, BYTE scanline, const ppu_video_memory & mem)
 {
-    // Get the current scanline (base y-coordinate) to render
-    BYTE scanline = CPU.readByte(PPU_LY);
-    
-    // Determine true Y-coordinate for background to be rendered using the SCROLL position for the Y coordinate and scanline
-    // Then, determine which tile row we're currently on based on the y-position. Divide by 8 because each tile is 8-pixels vertically, with 32 tiles per row
-    BYTE tile_position_y = CPU.readByte(PPU_SCROLLY) + scanline;
-    WORD tile_row_index = (BYTE(tile_position_y / 8)) * 32;
+    int count = 160 - screen_x;
 
-    // Render the 160 area based on what Scroll position and scanline we're in
-    for (int px = 0; px < 160; ++px)
+    // With a decoded layer, the line is a copy out of a row of the layer, in two pieces if it wraps around
+    if (mem.layers != NULL)
     {
-        // Get the current x-position based on the Scroll-X coordinate.
-        // Based off this position, determine which tile within the tile_row_index is to be used to render the current pixel (horizontally)
-        BYTE tile_position_x = px + CPU.readByte(PPU_SCROLLX);       
-        WORD tile_col_index = tile_position_x / 8;
+        const bg_layer & layer = GetBackgroundLayer(*mem.layers, loc_addr, data_addr, mem.vram);
+        int first = 256 - map_x;
+        if (first > count)
+            first = count;
 
-        // Get the final tile # address using the indexes calculated and the base tile use address
-        WORD tile_num_address = tile_col_index + tile_row_index + loc_addr; 
-
-        // Read the tile number from the memory. Either as signed or unsigned offset depending on data address selected
-        SIGNED_WORD tile_num;  // Multiplied by 16 because each tile takes 16-bytes to render 8x8 pixels
-        WORD start_tile_address;     // The starting address for the 16 bytes to render the 8x8 pixels
-        if (data_addr == 0x8800) // signed data
+        if (framebuffer_format == FRAMEBUFFER_INDEXED)
         {
-            tile_num = (SIGNED_BYTE)CPU.readByte(tile_num_address);
-            start_tile_address = data_addr + (tile_num + 128) * 16; // Add 128 to negate the signed offset. e.g #-128 would be $0*16 = $0 + $8800 = $8800. 
+            memcpy(&mem.frame->index_buffer[scanline][screen_x], &layer.shades[map_y][map_x], first);
+            memcpy(&mem.frame->index_buffer[scanline][screen_x + first], &layer.shades[map_y][0], count - first);
         }
         else
         {
-            tile_num = (BYTE)CPU.readByte(tile_num_address);
-            start_tile_address = data_addr + tile_num * 16;
+            memcpy(mem.frame->pixel_buffer[scanline][screen_x], layer.pixels[map_y][map_x], first * 4);
+            memcpy(mem.frame->pixel_buffer[scanline][screen_x + first], layer.pixels[map_y][0], (count - first) * 4);
         }
-
-        // Determine which byte out of the 16-byte tile we are in, using the current y-position modulo 8 to get a 0-7 range. x2 because we need 2 bytes per tile
-        WORD current_tile_address = start_tile_address + (tile_position_y % 8) * 2;
-
-        // TODO: Implement Tile palette data
-
-        // Use bit shifting and bitwise OR to get a 2-bit number using the bit at position tile_position
-        pixel color = getRBG( ((((CPU.readByte(current_tile_address)     >> (7 - (tile_position_x % 8))) & 0x01) << 1) & 0x02) +
-                                ((CPU.readByte(current_tile_address + 1) >> (7 - (tile_position_x % 8))) & 0x01));
-
-        // Populate pixel buffer with the tile color. Only use px and scanline in this area because this is the "true" pixel location.
-        pixel_buffer[scanline][px][1] = color.r;
-        pixel_buffer[scanline][px][2] = color.g;
-        pixel_buffer[scanline][px][3] = color.b;
-    }
-
-    return;
-}
-
-void RenderWindow(WORD loc_addr, WORD data_addr, GBCPU & CPU)
-{
-    // Render the window stored in memory
-    BYTE scanline = CPU.readByte(PPU_LY);
-
-    // Only render Window tiles if the scanline is within window position
-    if (scanline < CPU.readByte(PPU_WY))
         return;
+    }
 
-    // Determine true Y-coordinate for background to be rendered using the scanline (y-coordinate)
-    // Then, determine which tile row we're currently on based on the y-position. Divide by 8 because each tile is 8-pixels vertically, with 32 tiles per row
-    BYTE tile_position_y = scanline;
-    WORD tile_row_index = (BYTE(tile_position_y / 8)) * 32;
-
-    // Render the 160 area based on what Scroll position and scanline we're in
-    for (int px = CPU.readByte(PPU_WX) - 7; px < 160; ++px)
+    // Otherwise decode the line a tile at a time. Divide by 8 because each tile is 8-pixels vertically, with 32 tiles per row
+    WORD tile_row_index = (map_y / 8) * 32;
+    int px = screen_x;
+    BYTE tile_position_x = map_x;
+    while (px < 160)
     {
-        // Get the current x-position based on the WINDOW-X coordinate.
-        // Based off this position, determine which tile within the tile_row_index is to be used to render the current pixel (horizontally)
-        BYTE tile_position_x = px;
-        WORD tile_col_index = tile_position_x / 8;
-
         // Get the final tile # address using the indexes calculated and the base tile use address
-        WORD tile_num_address = tile_col_index + tile_row_index + loc_addr;
+        WORD tile_num_address = (tile_position_x / 8) + tile_row_index + loc_addr;
 
         // Read the tile number from the memory. Either as signed or unsigned offset depending on data address selected
         SIGNED_WORD tile_num;  // Multiplied by 16 because each tile takes 16-bytes to render 8x8 pixels
         WORD start_tile_address;     // The starting address for the 16 bytes to render the 8x8 pixels
         if (data_addr == 0x8800) // signed data
         {
-            tile_num = (SIGNED_BYTE)CPU.readByte(tile_num_address);
+            tile_num = (SIGNED_BYTE)VRAM_BYTE(mem, tile_num_address);
             start_tile_address = data_addr + (tile_num + 128) * 16; // Add 128 to negate the signed offset. e.g #-128 would be $0*16 = $0 + $8800 = $8800. 
         }
         else
         {
-            tile_num = (BYTE)CPU.readByte(tile_num_address);
+            tile_num = (BYTE)VRAM_BYTE(mem, tile_num_address);
             start_tile_address = data_addr + tile_num * 16;
         }
 
         // Determine which byte out of the 16-byte tile we are in, using the current y-position modulo 8 to get a 0-7 range. x2 because we need 2 bytes per tile
-        WORD current_tile_address = start_tile_address + (tile_position_y % 8) * 2;
+        WORD current_tile_address = start_tile_address + (map_y % 8) * 2;
+        BYTE tile1 = VRAM_BYTE(mem, current_tile_address);
+        BYTE tile2 = VRAM_BYTE(mem, current_tile_address + 1);
 
-        // TODO: Implement Window palette data
+        // Draw the rest of this tile's row
+        for (int bit = 7 - (tile_position_x % 8); (bit >= 0) && (px < 160); --bit, ++px, ++tile_position_x)
+        {
+            // Use bit shifting and bitwise OR to get a 2-bit number using the bit at position tile_position
+            BYTE value = (((tile1 >> bit) & 0x01) << 1) + ((tile2 >> bit) & 0x01);
 
-        // Use bit shifting and bitwise OR to get a 2-bit number using the bit at position tile_position
-        pixel color = getRBG( ((((CPU.readByte(current_tile_address)     >> (7 - (tile_position_x % 8))) & 0x01) << 1) & 0x02) +
-                                ((CPU.readByte(current_tile_address + 1) >> (7 - (tile_position_x % 8))) & 0x01));
+            // TODO: Implement Tile palette data
+            SetFramePixel(*mem.frame, scanline, px, getRBGShade(value));
+        }
+    }
+}
+
+void RenderTile(WORD loc_addr, WORD data_addr, const ppu_line_registers & regs, const ppu_video_memory & mem)
+{
+    // The background is scrolled by SCX/SCY, so screen pixel (0, LY) shows map pixel (SCX, SCY + LY)
+    DrawMapLine(loc_addr, data_addr, regs.scx, regs.scy + regs.ly, 0, regs.ly, mem);
+}
 
-        // Populate pixel buffer with the tile color. Only use px and scanline in this area because this is the "true" pixel location.
-        pixel_buffer[scanline][px][1] = color.r;
-        pixel_buffer[scanline][px][2] = color.g;
-        pixel_buffer[scanline][px][3] = color.b;
+void RenderWindow(WORD loc_addr, WORD data_addr, const ppu_line_registers & regs, const ppu_video_memory & mem)
+{
+    // Nothing to draw on lines the window does not show up on
+    if (regs.window_line == WINDOW_LINE_NONE)
+        return;
+
+    // The window's top left corner is drawn at (WX - 7, WY) and its rows follow the window line counter.
+    // With WX below 7, the first columns of the window are left of the screen
+    int screen_x = regs.wx - 7;
+    BYTE map_x = 0;
+    if (screen_x < 0)
+    {
+        map_x = -screen_x;
+        screen_x = 0;
     }
 
-    return;
+    DrawMapLine(loc_addr, data_addr, map_x, regs.window_line, screen_x, regs.ly, mem);
 }
 
-void RenderSprite(GBCPU & CPU, bool use_8X16)
+void RenderSprite(bool use_8X16, const ppu_line_registers & regs, const ppu_video_memory & mem)
 {
     // Render the sprite (OBJ) sotred in memory $8000 - $8FFF
     WORD loc_addr = 0x8000; // use unsigned numbering
     
     // Get the current scanline we're in
-    BYTE scanline = CPU.readByte(PPU_LY);
+    BYTE scanline = regs.ly;
+
+    // Pick the sprites on this scanline, highest priority first
+    BYTE line_sprites[MAX_SPRITES_PER_LINE];
+    BYTE sprite_count = GetLineSprites(mem.sprites, mem.oam, scanline, use_8X16, line_sprites);
 
-    // Loop through Sprite Attribute memory to render sprites on current scanline
-    for (BYTE sprite = 0; sprite < 40; ++sprite)
+    // Draw from lowest to highest priority so higher priority sprites end up on top
+    for (int i = sprite_count - 1; i >= 0; --i)
     {
         // Get sprite attribute information from the current index
-        WORD sprite_addr = sprite * 4 + SPRITE_TABLE_START;
+        WORD sprite_addr = line_sprites[i] * 4 + SPRITE_TABLE_START;
 
         // Get Y-position-16, X-position-8, Tile/Pattern #, and the Attribute/Flag
-        BYTE sprite_y_position = CPU.readByte(sprite_addr) - 16;
-        BYTE sprite_x_position = CPU.readByte(sprite_addr + 1) - 8;
-        BYTE tile_num_index    = CPU.readByte(sprite_addr + 2);     // Multiplied by 16 because each 8x8 tile takes 16 bytes
-        BYTE sprite_attribute  = CPU.readByte(sprite_addr + 3);
+        int  sprite_y_position = OAM_BYTE(mem, sprite_addr) - 16;
+        BYTE sprite_x_position = OAM_BYTE(mem, sprite_addr + 1) - 8;
+        BYTE tile_num_index    = OAM_BYTE(mem, sprite_addr + 2);     // Multiplied by 16 because each 8x8 tile takes 16 bytes
+        BYTE sprite_attribute  = OAM_BYTE(mem, sprite_addr + 3);
 
         // Check if we need to flip sprite along y-axis
         bool y_flip = (sprite_attribute & 0x04) ? true: false;
         bool x_flip = (sprite_attribute & 0x02) ? true: false;
 
-        // Only render sprite if it falls in current scanline
-        if ((scanline >= sprite_y_position) && 
-            (scanline < sprite_y_position + (use_8X16 ? 16 : 8)) )
+        // Get the current byte of the sprite to render. The sprite is known to cover this scanline
+        BYTE tile_num_y_offset = (scanline - sprite_y_position);
+        if(y_flip)
+        {
+            // Mirror the sprite vertically if y_flip attribute is present
+            tile_num_y_offset = (use_8X16 ? 16 : 8) - tile_num_y_offset;
+        }
+
+        // Get the index to the tile address through the base address, tile #, and the current horizontal line (*2 because each line is 2 bytes)
+        WORD tile_addr = loc_addr + tile_num_index * 16 + tile_num_y_offset * 2; 
+        BYTE tile1 = VRAM_BYTE(mem, tile_addr);
+        BYTE tile2 = VRAM_BYTE(mem, tile_addr + 1);
+
+        // Loop through the 2 bytes of data bit-by-bit, accounting 
+        for (int x = 0; x < 8; ++x)
         {
-            // Get the current byte of the sprite to render
-            BYTE tile_num_y_offset = (scanline - sprite_y_position);
-            if(y_flip)
-            {
-                // Mirror the sprite vertically if y_flip attribute is present
-                tile_num_y_offset = (use_8X16 ? 16 : 8) - tile_num_y_offset;
-            }
-
-            // Get the index to the tile address through the base address, tile #, and the current horizontal line (*2 because each line is 2 bytes)
-            WORD tile_addr = loc_addr + tile_num_index * 16 + tile_num_y_offset * 2; 
-            BYTE tile1 = CPU.readByte(tile_addr);
-            BYTE tile2 = CPU.readByte(tile_addr + 1);
-
-            // Loop through the 2 bytes of data bit-by-bit, accounting 
-            for (int x = 0; x < 8; ++x)
-            {
-                // TODO: Implement Sprite palette data
-
-                // Use bit shifting and bitwise OR to get a 2-bit number using the bit at position tile_position
-                pixel color = getRBG( ( ((tile1 >> (x_flip ? x : (7 - x))) & 0x01) << 1) +
-                                        ((tile2 >> (x_flip ? x : (7 - x))) & 0x01));
-
-                // Sprite pixels are transparent instead of white
-                if (color.r == 255)
-                    continue;
-
-                // Populate pixel buffer with the tile color. Only use px and scanline in this area because this is the "true" pixel location.
-                pixel_buffer[scanline][sprite_x_position + x][1] = color.r;
-                pixel_buffer[scanline][sprite_x_position + x][2] = color.g;
-                pixel_buffer[scanline][sprite_x_position + x][3] = color.b;
-
-            }
+            // TODO: Implement Sprite palette data
+
+            // Use bit shifting and bitwise OR to get a 2-bit number using the bit at position tile_position
+            BYTE value = ( ((tile1 >> (x_flip ? x : (7 - x))) & 0x01) << 1) +
+                           ((tile2 >> (x_flip ? x : (7 - x))) & 0x01);
+
+            // Sprite pixels are transparent instead of white
+            if (value == 0)
+                continue;
+
+            // Skip pixels that fall off either edge of the screen
+            if (BYTE(sprite_x_position + x) >= 160)
+                continue;
+
+            // Populate the frame with the tile color. Only use px and scanline in this area because this is the "true" pixel location.
+            SetFramePixel(*mem.frame, scanline, BYTE(sprite_x_position + x), getRBGShade(value));
+
         }
     }
 
@@ -425,6 +644,27 @@ pixel getRBG(BYTE value)
     return t;
 }
 
+/* Function: pixel getShadeColor(BYTE shade)
+             Returns the color of a shade as picked through a palette
+             register: 0 = white, 1 = light gray, 2 = dark gray, 3 = black.
+             Same colors as getRBG, which takes unpaletted color numbers. */
+pixel getShadeColor(BYTE shade)
+{
+    pixel t;
+    t.r = t.g = t.b = shade_levels[shade & 0x03];
+    return t;
+}
+
+/* Function: BYTE getRBGShade(BYTE value)
+             Returns the shade whose color is the one getRBG gives a color
+             number, for drawing unpaletted color numbers into the frame. */
+BYTE getRBGShade(BYTE value)
+{
+    static const BYTE value_shades[4] = { 0, 2, 1, 3 };
+
+    return value_shades[value & 0x03];
+}
+
 
 /* DEBUG FUNCTION: TestVideoRAM(GBCPU & CPU)
                    Fill video RAM with a temporary tile to ensure
@@ -464,7 +704,11 @@ void TestVideoRAM(GBCPU & CPU)
     for (int i = 0; i < 145; ++i)
     {
         CPU.MEM[PPU_LY] = i; // scanline
-        RenderTile(0x9C00, 0x8800, CPU);
+
+        // VRAM was filled in directly above, so the background cache knows nothing about it
+        ppu_video_memory mem = GetVideoMemory(CPU);
+        mem.layers = NULL;
+        RenderTile(0x9C00, 0x8800, GetLineRegisters(CPU), mem);
     }
     return;
 }
\ No newline at end of file
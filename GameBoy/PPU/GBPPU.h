@@ -3,14 +3,91 @@
 
 #include "GBCPU.h"
 #include "render.h"
+#include "oam_index.h"
+#include "bg_cache.h"
+#include "framebuffer.h"
 
+// PPU registers sampled at the moment a scanline is rendered. Everything a
+// scanline needs besides video memory is captured here, so a line can be drawn
+// later (or on another thread) exactly as it would have been drawn in place.
+typedef struct ppu_line_registers
+{
+    BYTE lcdc;
+    BYTE scx;
+    BYTE scy;
+    BYTE wx;
+    BYTE wy;
+    BYTE bgp;
+    BYTE obp0;
+    BYTE obp1;
+    BYTE ly;
+    BYTE window_line;   // Window row drawn on this line, WINDOW_LINE_NONE if the window isn't drawn
+} ppu_line_registers;
+
+// Window rows count from 0 on the first line the window is drawn. WX above WINDOW_X_MAX puts the window off screen
+#define WINDOW_LINE_NONE  0xFF
+#define WINDOW_X_MAX      166
+
+// Progress of the window through the current frame
+typedef struct ppu_window_state
+{
+    bool wy_triggered;  // LY matched WY at some point this frame
+    BYTE line;          // Window row to be drawn next
+} ppu_window_state;
+
+// PPU engines. The scanline engine renders a whole line at once; the pixel FIFO
+// engine steps the PPU one dot at a time, like the hardware does
+typedef enum ppu_engine_types
+{
+    PPU_ENGINE_SCANLINE,
+    PPU_ENGINE_FIFO
+} ppu_engine_types;
+
+// State of the scanline PPU engine, the engine in use, and the caches of video memory both engines draw from
+typedef struct ppu_state
+{
+    ppu_engine_types engine;         // Engine stepping this instance's PPU. Changed through SetPPUEngine
+    unsigned short scanline_counter; // Counter that keeps track of the number of cycles occured to increment the next scanline
+    unsigned int frame_count;        // Frames completed so far, by either engine
+    ppu_window_state window;         // Window line counter of the scanline renderer. Only touched on the CPU thread, as register snapshots are taken
+    bool lcd_enabled;                // False while the LCD is off and the PPU is suspended
+    oam_index sprite_index;          // Sprite index of the CPU's OAM
+    bg_layer_cache bg_cache;         // Background layers of the CPU's VRAM
+} ppu_state;
+
+// Video memory that a scanline is rendered from. Normally this points straight
+// into CPU memory, but the render thread keeps its own copy.
+typedef struct ppu_video_memory
+{
+    const BYTE * vram;          // $8000 - $9FFF
+    const BYTE * oam;           // $FE00 - $FE9F
+    const oam_index * sprites;  // Sprite index kept in step with oam, NULL to scan OAM instead
+    bg_layer_cache * layers;    // Decoded background layers kept in step with vram, NULL to decode tiles per pixel
+    frame_buffer * frame;       // Where the scanline is drawn
+} ppu_video_memory;
+
+// Read a byte of VRAM/OAM from a video memory view using its CPU address
+#define VRAM_BYTE(mem, addr) ((mem).vram[(addr) - VRAM_START])
+#define OAM_BYTE(mem, addr)  ((mem).oam[(addr) - SPRITE_TABLE_START])
+
+void InitPPU(GBCPU & CPU);
 void ExecutePPU(BYTE cycles, GBCPU & CPU);
 void UpdateLCDStatus(GBCPU & CPU);
+void WriteLCDControl(BYTE data, GBCPU & CPU);
+void FinishFrame(GBCPU & CPU);
+void WriteVideoMemory(WORD addr, BYTE data, GBCPU & CPU);
+void WriteSpriteTable(const BYTE * data, GBCPU & CPU);
 void RenderScanline(GBCPU & CPU);
-void RenderTile(WORD loc_addr, WORD data_addr, GBCPU & CPU);
-void RenderWindow(WORD loc_addr, WORD data_addr, GBCPU & CPU);
-void RenderSprite(GBCPU & CPU, bool use_8X16);
+void RenderScanline(const ppu_line_registers & regs, const ppu_video_memory & mem);
+void RenderTile(WORD loc_addr, WORD data_addr, const ppu_line_registers & regs, const ppu_video_memory & mem);
+void RenderWindow(WORD loc_addr, WORD data_addr, const ppu_line_registers & regs, const ppu_video_memory & mem);
+void RenderSprite(bool use_8X16, const ppu_line_registers & regs, const ppu_video_memory & mem);
+ppu_line_registers GetLineRegisters(GBCPU & CPU);
+BYTE NextWindowLine(ppu_window_state & window, const ppu_line_registers & regs);
+ppu_video_memory GetVideoMemory(GBCPU & CPU);
 struct pixel getRBG(BYTE value);
+struct pixel getShadeColor(BYTE shade);
+BYTE getRBGShade(BYTE value);
 
 void TestVideoRAM(GBCPU & CPU);
 
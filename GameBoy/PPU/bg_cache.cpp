@@ -0,0 +1,105 @@
+/*  Name:        bg_cache.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the decoded background layer cache. Each
+                 tile map is kept decoded into a 256x256 image, and only the
+                 tiles touched by VRAM writes are decoded again, so rendering
+                 a background or window line becomes a copy out of the layer. */
+
+#include "bg_cache.h"
+#include "GBPPU.h"
+
+
+/* Function: static bg_layer & SelectLayer(bg_layer_cache & cache, WORD map_addr, WORD data_addr)
+             Returns the layer used for a tile map/tile data pair. */
+static bg_layer & SelectLayer(bg_layer_cache & cache, WORD map_addr, WORD data_addr)
+{
+    return cache.layers[(map_addr == 0x9C00) ? 1 : 0][(data_addr == 0x8000) ? 1 : 0];
+}
+
+/* Function: static void DecodeTile(bg_layer & layer, WORD entry, WORD tile, const BYTE * vram)
+             Decodes an 8x8 tile into the layer at the position of a map entry. */
+static void DecodeTile(bg_layer & layer, WORD entry, WORD tile, const BYTE * vram)
+{
+    // Colors and shades for each 2-bit value, in pixel buffer and index buffer layout
+    BYTE colors[4][4];
+    BYTE shades[4];
+    for (BYTE value = 0; value < 4; ++value)
+    {
+        pixel color = getRBG(value);
+        colors[value][0] = 0;
+        colors[value][1] = color.r;
+        colors[value][2] = color.g;
+        colors[value][3] = color.b;
+        shades[value] = getRBGShade(value);
+    }
+
+    const BYTE * tile_data = &vram[tile * 16];
+    int top  = (entry / 32) * 8;
+    int left = (entry % 32) * 8;
+
+    for (int y = 0; y < 8; ++y)
+    {
+        BYTE byte1 = tile_data[y * 2];
+        BYTE byte2 = tile_data[y * 2 + 1];
+
+        for (int x = 0; x < 8; ++x)
+        {
+            // Same bit order as RenderTile: the first byte holds the upper bit of the color number
+            BYTE value = (((byte1 >> (7 - x)) & 0x01) << 1) + ((byte2 >> (7 - x)) & 0x01);
+            memcpy(layer.pixels[top + y][left + x], colors[value], 4);
+            layer.shades[top + y][left + x] = shades[value];
+        }
+    }
+}
+
+void ResetBackgroundCache(bg_layer_cache & cache)
+{
+    for (int map = 0; map < 2; ++map)
+    {
+        for (int data = 0; data < 2; ++data)
+        {
+            memset(cache.layers[map][data].entry_tile, 0xFF, sizeof(cache.layers[map][data].entry_tile));
+            memset(cache.layers[map][data].entry_version, 0, sizeof(cache.layers[map][data].entry_version));
+            cache.layers[map][data].version = 0;
+        }
+    }
+
+    memset(cache.tile_version, 0, sizeof(cache.tile_version));
+    cache.version = 1;
+}
+
+void UpdateBackgroundCache(bg_layer_cache & cache, WORD addr)
+{
+    // Tile data writes invalidate every map entry using the tile. Tile map writes are
+    // picked up by comparing each entry's tile # when the layer is next used
+    if (addr < 0x9800)
+        ++cache.tile_version[(addr - VRAM_START) / 16];
+
+    ++cache.version;
+}
+
+const bg_layer & GetBackgroundLayer(bg_layer_cache & cache, WORD map_addr, WORD data_addr, const BYTE * vram)
+{
+    bg_layer & layer = SelectLayer(cache, map_addr, data_addr);
+    if (layer.version == cache.version)
+        return layer;
+
+    const BYTE * map = &vram[map_addr - VRAM_START];
+    for (WORD entry = 0; entry < BG_MAP_ENTRIES; ++entry)
+    {
+        // Tiles are numbered from $8000: 0-255 for unsigned tile #s, 128-383 for signed
+        WORD tile = (data_addr == 0x8800) ? WORD(256 + (SIGNED_BYTE)map[entry]) : map[entry];
+
+        if ((layer.entry_tile[entry] == tile) && (layer.entry_version[entry] == cache.tile_version[tile]))
+            continue;
+
+        DecodeTile(layer, entry, tile, vram);
+        layer.entry_tile[entry] = tile;
+        layer.entry_version[entry] = cache.tile_version[tile];
+    }
+
+    layer.version = cache.version;
+    return layer;
+}
@@ -0,0 +1,42 @@
+#ifndef BG_CACHE_H
+#define BG_CACHE_H
+
+#include "gameboy.h"
+
+// Number of tile entries in a 32x32 tile map, and tiles in $8000 - $97FF
+#define BG_MAP_ENTRIES   1024
+#define BG_TILE_COUNT    384
+
+// A fully decoded 256x256 background, for one tile map and one tile data area.
+// Pixels are stored in the same layouts as the pixel buffer and the index
+// buffer, so a scanline of background (or window) is a straight copy out of a
+// row of the layer.
+typedef struct bg_layer
+{
+    BYTE pixels[256][256][4];
+    BYTE shades[256][256];
+    WORD entry_tile[BG_MAP_ENTRIES];             // Tile each map entry was decoded from, 0xFFFF if never decoded
+    unsigned int entry_version[BG_MAP_ENTRIES];  // Version of that tile when it was decoded
+    unsigned int version;                        // Cache version the layer was last brought up to date with
+} bg_layer;
+
+// Decoded layers for both tile maps and both tile data areas, kept in step
+// with one copy of VRAM. Tile map and tile data writes only bump version
+// counters; a layer is brought up to date the next time it is drawn from.
+typedef struct bg_layer_cache
+{
+    bg_layer layers[2][2];                       // [0 = $9800, 1 = $9C00][0 = $8800, 1 = $8000]
+    unsigned int tile_version[BG_TILE_COUNT];    // Bumped on every write to a tile's data
+    unsigned int version;                        // Bumped on every tile map or tile data write
+} bg_layer_cache;
+
+// Marks every layer as needing a full decode
+void ResetBackgroundCache(bg_layer_cache & cache);
+
+// Records a write that changes VRAM at addr
+void UpdateBackgroundCache(bg_layer_cache & cache, WORD addr);
+
+// Returns the decoded layer for a tile map/tile data pair, decoding any tiles that changed since it was last used
+const bg_layer & GetBackgroundLayer(bg_layer_cache & cache, WORD map_addr, WORD data_addr, const BYTE * vram);
+
+#endif /* bg_cache.h */
@@ -0,0 +1,186 @@
+/*  Name:        deferred_render.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the deferred rendering mode for the PPU.
+                 During the frame only the register snapshot of each scanline
+                 is logged, along with the previous contents of any VRAM/OAM
+                 byte overwritten after the first scanline. At V-Blank the log
+                 is walked backwards to rebuild the video memory each scanline
+                 saw, and all scanlines are rendered in parallel. */
+
+#include "deferred_render.h"
+#include "worker_pool.h"
+#include "context.h"
+
+// Scanlines gathered from the log when rendering a frame
+typedef struct deferred_line
+{
+    ppu_line_registers regs;
+    int copy;                 // Index into the copies of the frame log, or -1 for the current CPU memory
+} deferred_line;
+
+
+void StartDeferredRender(unsigned int threads, GBCPU & CPU)
+{
+    if (CPU.gb->deferred != NULL)
+        return;
+
+    deferred_render_state * state = new deferred_render_state;
+    state->log.reserve(4096);
+    state->log_has_lines = false;
+    state->log_line_count = 0;
+
+    StartWorkerPool(threads);
+    CPU.gb->deferred = state;
+}
+
+void StopDeferredRender(GBCPU & CPU)
+{
+    if (CPU.gb->deferred == NULL)
+        return;
+
+    RenderDeferredFrame(CPU);
+
+    delete CPU.gb->deferred;
+    CPU.gb->deferred = NULL;
+}
+
+void LogScanline(const ppu_line_registers & regs, GBCPU & CPU)
+{
+    deferred_render_state & state = *CPU.gb->deferred;
+
+    render_command cmd;
+    cmd.type = RENDER_CMD_LINE;
+    cmd.data = 0;
+    cmd.addr = 0;
+    cmd.regs = regs;
+
+    state.log.push_back(cmd);
+    state.log_has_lines = true;
+
+    // Render early if the frame never reaches V-Blank (e.g. LY was reset) so lines cannot pile up
+    if ((++state.log_line_count >= VBLANK_START) || (state.log.size() >= DEFERRED_LOG_LIMIT))
+        RenderDeferredFrame(CPU);
+}
+
+void LogVideoWrite(WORD addr, GBCPU & CPU)
+{
+    deferred_render_state & state = *CPU.gb->deferred;
+
+    // Writes before the first scanline are already reflected in what every scanline sees
+    if (state.log_has_lines == false)
+        return;
+
+    render_command cmd;
+    cmd.type = RENDER_CMD_WRITE;
+    cmd.data = CPU.MEM[addr];
+    cmd.addr = addr;
+
+    state.log.push_back(cmd);
+
+    // Keep long LCD-off loads from growing the log without bound
+    if (state.log.size() >= DEFERRED_LOG_LIMIT)
+        RenderDeferredFrame(CPU);
+}
+
+void RenderDeferredFrame(GBCPU & CPU)
+{
+    deferred_render_state & state = *CPU.gb->deferred;
+
+    if (state.log_has_lines == false)
+    {
+        state.log.clear();
+        return;
+    }
+
+    deferred_line lines[VBLANK_START];
+    bool line_seen[VBLANK_START] = { false };
+    unsigned int line_count = 0;
+    unsigned int copy_count = 0;
+
+    // Walk the log backwards from the current CPU memory. The first write met after a
+    // scanline starts a new copy, and each write restores the byte the earlier scanlines saw.
+    int current = -1;
+    bool current_in_use = true;
+    for (size_t i = state.log.size(); i-- > 0; )
+    {
+        const render_command & cmd = state.log[i];
+
+        if (cmd.type == RENDER_CMD_LINE)
+        {
+            // Only the latest render of a line is kept if a line was logged twice
+            if ((cmd.regs.ly < VBLANK_START) && (line_seen[cmd.regs.ly] == false))
+            {
+                line_seen[cmd.regs.ly] = true;
+                lines[line_count].regs = cmd.regs;
+                lines[line_count].copy = current;
+                ++line_count;
+            }
+
+            current_in_use = true;
+            continue;
+        }
+
+        if (current_in_use)
+        {
+            if (copy_count == state.copies.size())
+                state.copies.push_back(video_memory_copy());
+
+            video_memory_copy & copy = state.copies[copy_count];
+            if (current == -1)
+            {
+                memcpy(copy.vram, &CPU.MEM[VRAM_START], sizeof(copy.vram));
+                memcpy(copy.oam, &CPU.MEM[SPRITE_TABLE_START], sizeof(copy.oam));
+            }
+            else
+            {
+                copy = state.copies[current];
+            }
+
+            current = copy_count++;
+            current_in_use = false;
+        }
+
+        if (cmd.addr >= SPRITE_TABLE_START)
+            state.copies[current].oam[cmd.addr - SPRITE_TABLE_START] = cmd.data;
+        else
+            state.copies[current].vram[cmd.addr - VRAM_START] = cmd.data;
+    }
+
+    // Every line is independent given its registers and video memory, so render them all at once
+    ppu_video_memory cpu_mem = GetVideoMemory(CPU);
+
+    // Lines drawn from CPU memory share its background layers, which the workers may only read.
+    // Bring every layer those lines use up to date before handing them out
+    for (unsigned int i = 0; i < line_count; ++i)
+    {
+        if (lines[i].copy != -1)
+            continue;
+
+        BYTE lcdc = lines[i].regs.lcdc;
+        WORD data_addr = (lcdc & 0x10) ? 0x8000 : 0x8800;
+        if (lcdc & 0x01)
+            GetBackgroundLayer(*cpu_mem.layers, (lcdc & 0x08) ? 0x9C00 : 0x9800, data_addr, cpu_mem.vram);
+        if (lcdc & 0x20)
+            GetBackgroundLayer(*cpu_mem.layers, (lcdc & 0x40) ? 0x9C00 : 0x9800, data_addr, cpu_mem.vram);
+    }
+
+    ParallelFor(line_count, [&](unsigned int i)
+    {
+        ppu_video_memory mem = cpu_mem;
+        if (lines[i].copy != -1)
+        {
+            mem.vram = state.copies[lines[i].copy].vram;
+            mem.oam = state.copies[lines[i].copy].oam;
+            mem.sprites = NULL;
+            mem.layers = NULL;
+        }
+
+        RenderScanline(lines[i].regs, mem);
+    });
+
+    state.log.clear();
+    state.log_has_lines = false;
+    state.log_line_count = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef DEFERRED_RENDER_H
+#define DEFERRED_RENDER_H
+
+#include "GBPPU.h"
+#include "render_thread.h"
+
+#include <vector>
+
+// Number of frame log entries after which the logged scanlines are rendered early
+#define DEFERRED_LOG_LIMIT 65536
+
+// A copy of video memory as it was seen by one or more logged scanlines
+typedef struct video_memory_copy
+{
+    BYTE vram[VRAM_END - VRAM_START + 1];
+    BYTE oam[SPRITE_TABLE_END - SPRITE_TABLE_START + 1];
+} video_memory_copy;
+
+// The frame log of one emulator instance
+typedef struct deferred_render_state
+{
+    std::vector<render_command> log;            // Scanlines and VRAM/OAM undo records, in order
+    bool log_has_lines;                         // Writes only need undo records once a scanline is logged
+    unsigned int log_line_count;                // Scanlines logged since the last render
+    std::vector<video_memory_copy> copies;      // Older video memory rebuilt for earlier scanlines
+} deferred_render_state;
+
+// Enables deferred rendering for an instance: scanlines are logged during the frame and rendered
+// together at V-Blank, using the given number of worker threads (0 = one per spare core)
+void StartDeferredRender(unsigned int threads, GBCPU & CPU);
+
+// Renders anything still logged and returns to in-place rendering. The worker pool is shared
+// with other video work, so it is left running until StopWorkerPool
+void StopDeferredRender(GBCPU & CPU);
+
+// Logs a scanline to be rendered at the end of the frame
+void LogScanline(const ppu_line_registers & regs, GBCPU & CPU);
+
+// Logs the current contents of a VRAM/OAM address that is about to be overwritten
+void LogVideoWrite(WORD addr, GBCPU & CPU);
+
+// Renders every scanline logged since the last call, in parallel
+void RenderDeferredFrame(GBCPU & CPU);
+
+#endif /* deferred_render.h */
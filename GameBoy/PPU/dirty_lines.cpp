@@ -0,0 +1,90 @@
+/*  Name:        dirty_lines.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the dirty scanline tracking for the PPU.
+                 A scanline only depends on its PPU registers and video memory,
+                 so a line whose registers match the last time it was drawn,
+                 with no video memory changes in between, is already correct
+                 in the pixel buffer. Frames without any redrawn lines are not
+                 uploaded or presented again. */
+
+#include "dirty_lines.h"
+#include "context.h"
+
+// Define dirty line tracking variables
+bool dirty_lines_enabled = true;
+
+
+void ResetDirtyLines(dirty_line_state & state)
+{
+    memset(state.lines, 0, sizeof(state.lines));
+    state.video_generation = 1;
+    state.frame_dirty = true;
+    state.previous_frame_dirty = true;
+    state.frame_changed = true;
+    state.frames_unchanged = 0;
+    memset(&state.stats, 0, sizeof(state.stats));
+}
+
+void MarkVideoMemoryDirty(GBCPU & CPU)
+{
+    ++CPU.gb->dirty.video_generation;
+}
+
+bool IsScanlineDirty(const ppu_line_registers & regs, GBCPU & CPU)
+{
+    dirty_line_state & state = CPU.gb->dirty;
+
+    if (dirty_lines_enabled && (regs.ly < VBLANK_START))
+    {
+        line_state & line = state.lines[regs.ly];
+        if ((line.generation == state.video_generation) && (memcmp(&line.regs, &regs, sizeof(regs)) == 0))
+        {
+            ++state.stats.lines_skipped;
+            return false;
+        }
+
+        line.regs = regs;
+        line.generation = state.video_generation;
+    }
+
+    ++state.stats.lines_rendered;
+    state.frame_dirty = true;
+    state.frame_changed = true;
+    return true;
+}
+
+void MarkFrameDirty(GBCPU & CPU)
+{
+    CPU.gb->dirty.frame_dirty = true;
+    CPU.gb->dirty.frame_changed = true;
+}
+
+bool IsFrameDirty(GBCPU & CPU)
+{
+    dirty_line_state & state = CPU.gb->dirty;
+
+    // Lines logged by the deferred renderer land in the pixel buffer at the following V-Blank,
+    // so a frame stays dirty for one extra check after its last redrawn line
+    bool dirty = state.frame_dirty || state.previous_frame_dirty || (dirty_lines_enabled == false);
+    state.previous_frame_dirty = state.frame_dirty;
+    state.frame_dirty = false;
+
+    if (dirty || (++state.frames_unchanged >= FRAME_REFRESH_INTERVAL))
+    {
+        state.frames_unchanged = 0;
+        ++state.stats.frames_presented;
+        return true;
+    }
+
+    ++state.stats.frames_skipped;
+    return false;
+}
+
+bool IsFrameChanged(GBCPU & CPU)
+{
+    bool changed = CPU.gb->dirty.frame_changed;
+    CPU.gb->dirty.frame_changed = false;
+    return changed;
+}
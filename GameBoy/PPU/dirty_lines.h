@@ -0,0 +1,61 @@
+#ifndef DIRTY_LINES_H
+#define DIRTY_LINES_H
+
+#include "GBPPU.h"
+
+// Number of unchanged frames after which the screen is presented anyway, so a
+// resized or uncovered window does not stay blank through a long static screen
+#define FRAME_REFRESH_INTERVAL 60
+
+// Counts of the work saved by skipping unchanged scanlines and frames
+typedef struct video_skip_stats
+{
+    unsigned long long lines_rendered;
+    unsigned long long lines_skipped;
+    unsigned long long frames_presented;
+    unsigned long long frames_skipped;
+} video_skip_stats;
+
+// What each scanline was last rendered from
+typedef struct line_state
+{
+    ppu_line_registers regs;
+    unsigned int generation;    // video_generation at the time
+} line_state;
+
+// Dirty line tracking state of one emulator instance
+typedef struct dirty_line_state
+{
+    line_state lines[VBLANK_START];
+    unsigned int video_generation;  // Bumped on every VRAM/OAM change. Lines start out at 0, so all are drawn once
+    bool frame_dirty;               // A line was rendered since the last frame check
+    bool previous_frame_dirty;      // ...and the same for the check before that
+    bool frame_changed;             // A line was rendered since the PPU last completed a frame
+    unsigned int frames_unchanged;
+    video_skip_stats stats;
+} dirty_line_state;
+
+/* Dirty line tracking settings (dirty_lines.cpp) */
+extern bool dirty_lines_enabled;     // Unchanged scanlines and frames are skipped
+
+// Marks every line as needing to be drawn, and clears the stats
+void ResetDirtyLines(dirty_line_state & state);
+
+// Records a write that changed VRAM or OAM. Every line is drawn again afterwards
+void MarkVideoMemoryDirty(GBCPU & CPU);
+
+// Returns true if a scanline has to be rendered: its registers or video memory
+// changed since the line was last rendered into the pixel buffer
+bool IsScanlineDirty(const ppu_line_registers & regs, GBCPU & CPU);
+
+// Records that pixels were drawn into the pixel buffer outside of IsScanlineDirty
+void MarkFrameDirty(GBCPU & CPU);
+
+// Returns true if the pixel buffer has to be uploaded and presented this frame
+bool IsFrameDirty(GBCPU & CPU);
+
+// Returns true if any line was rendered into the pixel buffer since the last
+// call. Called once per frame completed by the PPU
+bool IsFrameChanged(GBCPU & CPU);
+
+#endif /* dirty_lines.h */
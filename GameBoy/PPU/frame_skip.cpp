@@ -0,0 +1,68 @@
+/*  Name:        frame_skip.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the frame skip logic. Skipped frames run
+                 the PPU's LY/STAT/interrupt timing as usual but do not render
+                 any scanlines, which have no side effects on the emulated
+                 machine. Frames are skipped either at a fixed rate or only
+                 while the emulator is running behind real time. */
+
+#include "frame_skip.h"
+#include "context.h"
+
+// Define frame skip settings
+unsigned int frame_skip = 0;
+bool frame_skip_adaptive = false;
+
+
+void ResetFrameSkip(frame_skip_state & state)
+{
+    state.frame_skipped = false;
+    state.frames_skipped_in_row = 0;
+    state.frame_time_debt = 0;
+    state.last_vblank = std::chrono::steady_clock::time_point();
+    state.last_vblank_valid = false;
+}
+
+bool IsFrameSkipped(GBCPU & CPU)
+{
+    return CPU.gb->skip.frame_skipped;
+}
+
+void AdvanceFrameSkip(GBCPU & CPU)
+{
+    frame_skip_state & state = CPU.gb->skip;
+
+    if (frame_skip_adaptive)
+    {
+        // Keep track of how far behind real time the frames have fallen
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (state.last_vblank_valid)
+        {
+            long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - state.last_vblank).count();
+            state.frame_time_debt += elapsed - FRAME_TIME_BUDGET;
+            if (state.frame_time_debt < 0)
+                state.frame_time_debt = 0;
+
+            // Don't let a long stall (or a host that can never keep up) build up an endless backlog
+            if (state.frame_time_debt > FRAME_SKIP_MAX * FRAME_TIME_BUDGET)
+                state.frame_time_debt = FRAME_SKIP_MAX * FRAME_TIME_BUDGET;
+        }
+
+        state.last_vblank = now;
+        state.last_vblank_valid = true;
+
+        // Skip while more than a frame behind. Each skipped frame is expected to catch up on its own
+        state.frame_skipped = (state.frame_time_debt > FRAME_TIME_BUDGET) && (state.frames_skipped_in_row < FRAME_SKIP_MAX);
+    }
+    else
+    {
+        state.frame_skipped = (frame_skip != 0) && (state.frames_skipped_in_row < frame_skip);
+    }
+
+    if (state.frame_skipped)
+        ++state.frames_skipped_in_row;
+    else
+        state.frames_skipped_in_row = 0;
+}
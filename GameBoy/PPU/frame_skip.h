@@ -0,0 +1,37 @@
+#ifndef FRAME_SKIP_H
+#define FRAME_SKIP_H
+
+#include "GBCPU.h"
+
+#include <chrono>
+
+// Host time available for one emulated frame (59.73 frames per second), in microseconds
+#define FRAME_TIME_BUDGET   16742
+
+// Most frames skipped in a row by the adaptive frame skip, so the screen still updates when far behind
+#define FRAME_SKIP_MAX      8
+
+// Frame skip state of one emulator instance
+typedef struct frame_skip_state
+{
+    bool frame_skipped;                 // The current frame is not rendered
+    unsigned int frames_skipped_in_row;
+    long long frame_time_debt;          // Host time behind real time, in microseconds
+    std::chrono::steady_clock::time_point last_vblank;
+    bool last_vblank_valid;
+} frame_skip_state;
+
+/* Frame skip settings (frame_skip.cpp) */
+extern unsigned int frame_skip;     // Frames skipped after each rendered frame. 0 renders every frame
+extern bool frame_skip_adaptive;    // Skip frames only while emulation runs behind real time
+
+// Starts over with the next frame rendered
+void ResetFrameSkip(frame_skip_state & state);
+
+// Returns true if the scanlines of the current frame are not to be rendered
+bool IsFrameSkipped(GBCPU & CPU);
+
+// Decides whether the next frame is rendered. Called once per frame at V-Blank
+void AdvanceFrameSkip(GBCPU & CPU);
+
+#endif /* frame_skip.h */
@@ -0,0 +1,115 @@
+/*  Name:        oam_index.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the per-scanline sprite index. The index is
+                 updated on every OAM write so that selecting the sprites for a
+                 scanline only visits the sprites that are actually on it. */
+
+#include "oam_index.h"
+
+
+/* Function: static void SetSpriteLines(oam_index & index, BYTE sprite, BYTE y, bool set)
+             Sets or clears a sprite's bit on every visible line it covers
+             when placed at OAM Y-position y, for both sprite sizes. */
+static void SetSpriteLines(oam_index & index, BYTE sprite, BYTE y, bool set)
+{
+    unsigned long long bit = 1ULL << sprite;
+
+    for (int size = 0; size < 2; ++size)
+    {
+        // OAM Y-position is the sprite's screen position + 16
+        int top = (int)y - 16;
+        int bottom = top + (size ? MAX_SPRITES_COL : MIN_SPRITES_COL);
+
+        for (int line = (top < 0 ? 0 : top); (line < bottom) && (line < VBLANK_START); ++line)
+        {
+            if (set)
+                index.line_mask[size][line] |= bit;
+            else
+                index.line_mask[size][line] &= ~bit;
+        }
+    }
+}
+
+/* Function: static int LowestSetBit(unsigned long long mask)
+             Returns the position of the lowest set bit of a non-zero mask. */
+static int LowestSetBit(unsigned long long mask)
+{
+#ifdef _MSC_VER
+    unsigned long position;
+    if (_BitScanForward(&position, (unsigned long)(mask & 0xFFFFFFFF)))
+        return (int)position;
+
+    _BitScanForward(&position, (unsigned long)(mask >> 32));
+    return (int)position + 32;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+void ResetOAMIndex(oam_index & index, const BYTE * oam)
+{
+    memset(&index, 0, sizeof(index));
+    memcpy(index.oam, oam, sizeof(index.oam));
+
+    for (BYTE sprite = 0; sprite < MAX_SPRITES; ++sprite)
+        SetSpriteLines(index, sprite, index.oam[sprite * 4], true);
+}
+
+void UpdateOAMIndex(oam_index & index, WORD addr, BYTE data)
+{
+    WORD offset = addr - SPRITE_TABLE_START;
+
+    // Only a change of Y-position moves a sprite to other lines
+    if (((offset % 4) == 0) && (index.oam[offset] != data))
+    {
+        SetSpriteLines(index, offset / 4, index.oam[offset], false);
+        SetSpriteLines(index, offset / 4, data, true);
+    }
+
+    index.oam[offset] = data;
+}
+
+BYTE GetLineSprites(const oam_index * index, const BYTE * oam, BYTE ly, bool use_8X16, BYTE sprites[MAX_SPRITES_PER_LINE])
+{
+    unsigned long long mask = 0;
+
+    if (ly >= VBLANK_START)
+        return 0;
+
+    if (index != NULL)
+    {
+        mask = index->line_mask[use_8X16 ? 1 : 0][ly];
+        oam = index->oam;
+    }
+    else
+    {
+        // No index available for this copy of OAM; find the sprites the slow way
+        for (BYTE sprite = 0; sprite < MAX_SPRITES; ++sprite)
+        {
+            int top = (int)oam[sprite * 4] - 16;
+            if ((ly >= top) && (ly < top + (use_8X16 ? MAX_SPRITES_COL : MIN_SPRITES_COL)))
+                mask |= 1ULL << sprite;
+        }
+    }
+
+    // The PPU only picks up the first 10 sprites in OAM order on each line
+    BYTE count = 0;
+    while ((mask != 0) && (count < MAX_SPRITES_PER_LINE))
+    {
+        BYTE sprite = (BYTE)LowestSetBit(mask);
+        mask &= mask - 1;
+
+        // Insert by priority: lower X wins, ties go to the lower OAM index (already in order)
+        BYTE pos = count++;
+        while ((pos > 0) && (oam[sprites[pos - 1] * 4 + 1] > oam[sprite * 4 + 1]))
+        {
+            sprites[pos] = sprites[pos - 1];
+            --pos;
+        }
+        sprites[pos] = sprite;
+    }
+
+    return count;
+}
@@ -0,0 +1,27 @@
+#ifndef OAM_INDEX_H
+#define OAM_INDEX_H
+
+#include "gameboy.h"
+
+// Mirror of the sprite attribute table (OAM) that keeps track of which sprites
+// cover each visible scanline. Bit n of a line mask is set if sprite n overlaps
+// the line. Masks are kept for both sprite sizes so that LCDC bit 2 can change
+// between scanlines without rebuilding anything.
+typedef struct oam_index
+{
+    BYTE oam[MAX_SPRITES * 4];                          // Copy of $FE00 - $FE9F
+    unsigned long long line_mask[2][VBLANK_START];      // [0] = 8x8 sprites, [1] = 8x16 sprites
+} oam_index;
+
+// Rebuilds an index from a full copy of OAM
+void ResetOAMIndex(oam_index & index, const BYTE * oam);
+
+// Updates an index for a single write to OAM
+void UpdateOAMIndex(oam_index & index, WORD addr, BYTE data);
+
+// Selects the sprites drawn on a scanline: the first 10 in OAM order that overlap the line,
+// sorted so the highest priority sprite (lowest X, then lowest OAM index) comes first.
+// If no index is given, OAM is scanned directly. Returns the number of sprites selected.
+BYTE GetLineSprites(const oam_index * index, const BYTE * oam, BYTE ly, bool use_8X16, BYTE sprites[MAX_SPRITES_PER_LINE]);
+
+#endif /* oam_index.h */
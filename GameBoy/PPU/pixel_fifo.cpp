@@ -0,0 +1,441 @@
+/*  Name:        pixel_fifo.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the pixel FIFO PPU engine. Instead of
+                 drawing a scanline at once, the PPU is stepped one dot at a
+                 time: OAM search, the background/window tile fetcher feeding
+                 a pixel FIFO, sprite fetches stalling the output, and H-Blank.
+                 Mode 3 takes as long as it would on hardware (SCX fine scroll,
+                 window start and sprite fetch penalties), and registers
+                 written mid-line take effect on the following pixels. */
+
+#include "pixel_fifo.h"
+#include "dirty_lines.h"
+#include "frame_skip.h"
+#include "framebuffer.h"
+#include "context.h"
+
+
+/* Function: static void SetMode(BYTE mode, GBCPU & CPU)
+             Enters a new STAT mode. */
+static void SetMode(BYTE mode, GBCPU & CPU)
+{
+    CPU.gb->fifo.mode = mode;
+    CPU.MEM[STAT] = (CPU.MEM[STAT] & 0xFC) | mode;
+}
+
+/* Function: static void UpdateStatLine(GBCPU & CPU)
+             Updates the coincidence flag and requests an LCD STAT interrupt
+             when any enabled STAT condition becomes true. */
+static void UpdateStatLine(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    BYTE stat = CPU.MEM[STAT];
+    bool coincidence = (CPU.MEM[PPU_LYC] == CPU.MEM[PPU_LY]);
+    CPU.MEM[STAT] = (coincidence ? (stat | 0x04) : (stat & 0xFB));
+
+    bool stat_line = (coincidence && (stat & 0x40)) ||
+                     ((fifo.mode == 2) && (stat & 0x20)) ||
+                     ((fifo.mode == 1) && (stat & 0x10)) ||
+                     ((fifo.mode == 0) && (stat & 0x08));
+
+    // Only a rising edge of the combined line requests an interrupt
+    if (stat_line && (fifo.stat_line == false))
+        CPU.MEM[INTERRUPT_FLAG] |= 0x02;
+
+    fifo.stat_line = stat_line;
+}
+
+/* Function: static void StartLine(GBCPU & CPU)
+             Sets up the PPU at dot 0 of the scanline in LY. */
+static void StartLine(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    BYTE ly = CPU.MEM[PPU_LY];
+
+    if (ly == 0)
+    {
+        fifo.wy_triggered = false;
+        fifo.window_line = 0;
+    }
+
+    if (ly < VBLANK_START)
+    {
+        // Mode 2 - OAM search picks the sprites for this line
+        SetMode(2, CPU);
+        if (ly == CPU.MEM[PPU_WY])
+            fifo.wy_triggered = true;
+
+        fifo.sprite_count = GetLineSprites(&CPU.gb->PPU.sprite_index, &CPU.MEM[SPRITE_TABLE_START], ly,
+                                           (CPU.MEM[LCDC] & 0x04) ? true : false, fifo.sprites);
+    }
+    else if (ly == VBLANK_START)
+    {
+        // Mode 1 - V-Blank
+        SetMode(1, CPU);
+        CPU.MEM[INTERRUPT_FLAG] |= 0x01;
+
+        FinishFrame(CPU);
+    }
+}
+
+/* Function: static void StartMode3(GBCPU & CPU)
+             Resets the fetcher and FIFOs at the start of pixel transfer. */
+static void StartMode3(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    SetMode(3, CPU);
+
+    fifo.lx = 0;
+    fifo.discard = CPU.MEM[PPU_SCROLLX] & 0x07;
+    fifo.fetch_delay = 6;
+    fifo.fetch_dots = 0;
+    fifo.fetch_x = 0;
+    fifo.bg_head = 0;
+    fifo.bg_count = 0;
+    fifo.obj_head = 0;
+    fifo.obj_count = 0;
+    fifo.in_window = false;
+    fifo.window_drawn = false;
+    fifo.next_sprite = 0;
+    fifo.sprite_pending = false;
+}
+
+/* Function: static bool FetcherReady(GBCPU & CPU)
+             Returns true if the fetcher holds a whole tile row waiting to be pushed. */
+static bool FetcherReady(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    return (fifo.fetch_delay == 0) && (fifo.fetch_dots == 6);
+}
+
+/* Function: static void TickFetcher(GBCPU & CPU)
+             Advances the background/window tile fetcher by one dot. Each of
+             the tile #, low byte and high byte reads takes 2 dots, and the
+             row is pushed once the background FIFO has run empty. */
+static void TickFetcher(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    if (fifo.fetch_delay > 0)
+    {
+        --fifo.fetch_delay;
+        return;
+    }
+
+    BYTE lcdc = CPU.MEM[LCDC];
+    BYTE ly = CPU.MEM[PPU_LY];
+
+    if (fifo.fetch_dots < 6)
+    {
+        ++fifo.fetch_dots;
+
+        // Row of the tile map and row within the tile being fetched
+        BYTE map_y = (fifo.in_window ? fifo.window_line : BYTE(CPU.MEM[PPU_SCROLLY] + ly));
+
+        if (fifo.fetch_dots == 2)
+        {
+            WORD map_addr;
+            BYTE tile_col;
+            if (fifo.in_window)
+            {
+                map_addr = (lcdc & 0x40) ? 0x9C00 : 0x9800;
+                tile_col = fifo.fetch_x;
+            }
+            else
+            {
+                map_addr = (lcdc & 0x08) ? 0x9C00 : 0x9800;
+                tile_col = (CPU.MEM[PPU_SCROLLX] / 8) + fifo.fetch_x;
+            }
+
+            fifo.tile_num = CPU.MEM[map_addr + (map_y / 8) * 32 + (tile_col & 0x1F)];
+        }
+        else if ((fifo.fetch_dots == 4) || (fifo.fetch_dots == 6))
+        {
+            // $8000 uses unsigned tile #s, $8800 signed tile #s centered on $9000
+            WORD tile_addr = (lcdc & 0x10) ? (0x8000 + fifo.tile_num * 16)
+                                           : (0x9000 + (SIGNED_BYTE)fifo.tile_num * 16);
+            tile_addr += (map_y % 8) * 2;
+
+            if (fifo.fetch_dots == 4)
+                fifo.tile_low = CPU.MEM[tile_addr];
+            else
+                fifo.tile_high = CPU.MEM[tile_addr + 1];
+        }
+
+        return;
+    }
+
+    // Push the row once the FIFO is empty, leftmost pixel first
+    if (fifo.bg_count == 0)
+    {
+        for (int x = 0; x < 8; ++x)
+        {
+            fifo_pixel & px = fifo.bg[(fifo.bg_head + x) & 0x0F];
+            px.color = (((fifo.tile_high >> (7 - x)) & 0x01) << 1) | ((fifo.tile_low >> (7 - x)) & 0x01);
+            px.palette = 0;
+            px.priority = 0;
+        }
+
+        fifo.bg_count = 8;
+        fifo.fetch_dots = 0;
+        ++fifo.fetch_x;
+    }
+}
+
+/* Function: static void FetchSprite(GBCPU & CPU)
+             Reads the row of the next sprite on this line and mixes it into
+             the sprite FIFO. Pixels already held by an earlier (higher
+             priority) sprite are left alone. */
+static void FetchSprite(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    BYTE lcdc = CPU.MEM[LCDC];
+    WORD sprite_addr = SPRITE_TABLE_START + fifo.sprites[fifo.next_sprite] * 4;
+
+    int  sprite_y_position = CPU.MEM[sprite_addr] - 16;
+    BYTE sprite_x          = CPU.MEM[sprite_addr + 1];
+    BYTE tile_num_index    = CPU.MEM[sprite_addr + 2];
+    BYTE sprite_attribute  = CPU.MEM[sprite_addr + 3];
+
+    // 8x16 sprites ignore bit 0 of the tile #. The size may have changed since OAM search, so keep the row in range
+    BYTE sprite_height = (lcdc & 0x04) ? 16 : 8;
+    if (lcdc & 0x04)
+        tile_num_index &= 0xFE;
+
+    BYTE row = BYTE(CPU.MEM[PPU_LY] - sprite_y_position) & (sprite_height - 1);
+    if (sprite_attribute & 0x40)
+        row = sprite_height - 1 - row;
+
+    WORD tile_addr = 0x8000 + tile_num_index * 16 + row * 2;
+    BYTE tile_low = CPU.MEM[tile_addr];
+    BYTE tile_high = CPU.MEM[tile_addr + 1];
+
+    // Fill the sprite FIFO up with transparent pixels so the whole sprite fits
+    while (fifo.obj_count < 8)
+    {
+        fifo_pixel & px = fifo.obj[(fifo.obj_head + fifo.obj_count) & 0x07];
+        px.color = 0;
+        px.palette = 0;
+        px.priority = 0;
+        ++fifo.obj_count;
+    }
+
+    // Pixels of a sprite hanging off the left edge are never output
+    BYTE first = (sprite_x < 8) ? (8 - sprite_x) : 0;
+    for (BYTE x = first; x < 8; ++x)
+    {
+        BYTE bit = (sprite_attribute & 0x20) ? x : (7 - x);
+        BYTE color = (((tile_high >> bit) & 0x01) << 1) | ((tile_low >> bit) & 0x01);
+
+        fifo_pixel & px = fifo.obj[(fifo.obj_head + x - first) & 0x07];
+        if ((px.color == 0) && (color != 0))
+        {
+            px.color = color;
+            px.palette = (sprite_attribute & 0x10) ? 1 : 0;
+            px.priority = (sprite_attribute & 0x80) ? 1 : 0;
+        }
+    }
+
+    fifo.sprite_pending = false;
+    ++fifo.next_sprite;
+}
+
+/* Function: static bool SpriteStartsHere(GBCPU & CPU)
+             Returns true if the next sprite on this line starts at the
+             current pixel. Sprites left behind (e.g. while sprites were
+             disabled) are dropped. */
+static bool SpriteStartsHere(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    if (((CPU.MEM[LCDC] & 0x02) == 0) || (fifo.discard > 0))
+        return false;
+
+    while (fifo.next_sprite < fifo.sprite_count)
+    {
+        BYTE sprite_x = CPU.MEM[SPRITE_TABLE_START + fifo.sprites[fifo.next_sprite] * 4 + 1];
+        int start = (sprite_x < 8) ? 0 : (sprite_x - 8);
+
+        if (start > fifo.lx)
+            return false;
+        if (start == fifo.lx)
+            return true;
+
+        ++fifo.next_sprite;
+    }
+
+    return false;
+}
+
+/* Function: static void OutputPixel(GBCPU & CPU)
+             Pops a pixel off the FIFOs, mixes background and sprite, and
+             writes it to the pixel buffer. */
+static void OutputPixel(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    BYTE lcdc = CPU.MEM[LCDC];
+
+    fifo_pixel bg = fifo.bg[fifo.bg_head];
+    fifo.bg_head = (fifo.bg_head + 1) & 0x0F;
+    --fifo.bg_count;
+
+    // Drop the first SCX % 8 pixels of the line for fine scrolling
+    if (fifo.discard > 0)
+    {
+        --fifo.discard;
+        return;
+    }
+
+    // LCDC bit 0 blanks both background and window
+    BYTE bg_color = (lcdc & 0x01) ? bg.color : 0;
+    BYTE shade = (CPU.MEM[PPU_BGP] >> (bg_color * 2)) & 0x03;
+
+    if (fifo.obj_count > 0)
+    {
+        fifo_pixel obj = fifo.obj[fifo.obj_head];
+        fifo.obj_head = (fifo.obj_head + 1) & 0x07;
+        --fifo.obj_count;
+
+        if ((obj.color != 0) && (lcdc & 0x02) && ((obj.priority == 0) || (bg_color == 0)))
+            shade = (CPU.MEM[obj.palette ? PPU_OBP1 : PPU_OBP0] >> (obj.color * 2)) & 0x03;
+    }
+
+    if (IsFrameSkipped(CPU) == false)
+        SetFramePixel(CPU.gb->frame, CPU.MEM[PPU_LY], fifo.lx, shade);
+
+    // Mode 0 - H-Blank starts as soon as the last pixel is out
+    if (++fifo.lx == 160)
+    {
+        SetMode(0, CPU);
+
+        if (fifo.window_drawn)
+            ++fifo.window_line;
+
+        if (IsFrameSkipped(CPU) == false)
+            MarkFrameDirty(CPU);
+    }
+}
+
+/* Function: static void StepMode3(GBCPU & CPU)
+             Runs one dot of pixel transfer. */
+static void StepMode3(GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    // Sprite fetches hold up pixel output. The background fetch in progress has to finish first
+    if (fifo.sprite_pending)
+    {
+        if (FetcherReady(CPU) == false)
+            TickFetcher(CPU);
+        else if (++fifo.sprite_dots == 6)
+            FetchSprite(CPU);
+
+        return;
+    }
+
+    TickFetcher(CPU);
+    if (fifo.bg_count == 0)
+        return;
+
+    // The window starts once the output reaches WX - 7: the FIFO is cleared and fetching restarts from the window map
+    BYTE lcdc = CPU.MEM[LCDC];
+    if ((fifo.in_window == false) && (lcdc & 0x20) && fifo.wy_triggered &&
+        (fifo.discard == 0) && (fifo.lx + 7 >= CPU.MEM[PPU_WX]))
+    {
+        fifo.in_window = true;
+        fifo.window_drawn = true;
+        fifo.bg_count = 0;
+        fifo.fetch_dots = 0;
+        fifo.fetch_x = 0;
+        return;
+    }
+
+    if (SpriteStartsHere(CPU))
+    {
+        // This dot already counts towards the sprite fetch if the fetcher is idle
+        fifo.sprite_pending = true;
+        fifo.sprite_dots = (FetcherReady(CPU) ? 1 : 0);
+        return;
+    }
+
+    OutputPixel(CPU);
+}
+
+void SetPPUEngine(ppu_engine_types engine, GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    if (engine == CPU.gb->PPU.engine)
+        return;
+
+    if (engine == PPU_ENGINE_FIFO)
+    {
+        // Pick up at the same dot. A line already past OAM search finishes in H-Blank
+        fifo.dot = CPU.gb->PPU.scanline_counter % DOTS_PER_LINE;
+        fifo.mode = 0;
+        fifo.stat_line = false;
+        fifo.lx = 160;
+        fifo.sprite_count = 0;
+        fifo.wy_triggered = false;
+        fifo.window_line = 0;
+        fifo.lcd_on = false;
+    }
+    else
+    {
+        CPU.gb->PPU.scanline_counter = fifo.dot;
+    }
+
+    CPU.gb->PPU.engine = engine;
+}
+
+void ExecutePixelFIFO(BYTE cycles, GBCPU & CPU)
+{
+    pixel_fifo & fifo = CPU.gb->fifo;
+
+    // The PPU sits at the start of line 0 while the LCD is off
+    if ((CPU.MEM[LCDC] & 0x80) == 0x00)
+    {
+        fifo.dot = 0;
+        CPU.MEM[PPU_LY] = 0;
+        SetMode(0, CPU);
+        fifo.stat_line = false;
+        fifo.lcd_on = false;
+        return;
+    }
+
+    if (fifo.lcd_on == false)
+    {
+        fifo.lcd_on = true;
+        if (fifo.dot == 0)
+            StartLine(CPU);
+    }
+
+    for (BYTE i = 0; i < cycles; ++i)
+    {
+        if (CPU.MEM[PPU_LY] < VBLANK_START)
+        {
+            if (fifo.dot == OAM_SEARCH_DOTS)
+                StartMode3(CPU);
+
+            if (fifo.mode == 3)
+                StepMode3(CPU);
+        }
+
+        if (++fifo.dot == DOTS_PER_LINE)
+        {
+            fifo.dot = 0;
+            CPU.MEM[PPU_LY] = (CPU.MEM[PPU_LY] >= VBLANK_END) ? 0 : CPU.MEM[PPU_LY] + 1;
+            StartLine(CPU);
+        }
+
+        UpdateStatLine(CPU);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef PIXEL_FIFO_H
+#define PIXEL_FIFO_H
+
+#include "GBPPU.h"
+
+// Dots (clock cycles) per scanline and in the OAM search of each visible line
+#define DOTS_PER_LINE        456
+#define OAM_SEARCH_DOTS      80
+
+// A single pixel waiting in the background or sprite FIFO
+typedef struct fifo_pixel
+{
+    BYTE color;      // 2-bit color number, 0 is transparent for sprites
+    BYTE palette;    // Sprites only: 0 = OBP0, 1 = OBP1
+    BYTE priority;   // Sprites only: 1 = drawn behind background colors 1-3
+} fifo_pixel;
+
+// State of the pixel FIFO engine
+typedef struct pixel_fifo
+{
+    WORD dot;                                   // Dot within the current scanline, 0 - 455
+    BYTE mode;                                  // Current STAT mode
+    bool stat_line;                             // STAT interrupt line, interrupts are requested on its rising edge
+
+    // Mode 3 state
+    BYTE lx;                                    // Next screen pixel to be output
+    BYTE discard;                               // Pixels still to be dropped for SCX fine scroll
+    BYTE fetch_delay;                           // Dots left before the first tile fetch of the line
+    BYTE fetch_dots;                            // Dots spent on the current tile fetch. 6 = waiting to push
+    BYTE fetch_x;                               // Tile column being fetched
+    BYTE tile_num;
+    BYTE tile_low;
+    BYTE tile_high;
+    fifo_pixel bg[16];                          // Background FIFO ring
+    BYTE bg_head;
+    BYTE bg_count;
+    fifo_pixel obj[8];                          // Sprite FIFO ring, always read alongside the background FIFO
+    BYTE obj_head;
+    BYTE obj_count;
+
+    // Window state
+    bool wy_triggered;                          // LY matched WY at some point this frame
+    bool in_window;                             // Fetching window tiles on this line
+    bool window_drawn;                          // The window showed up on this line
+    BYTE window_line;                           // Internal window line counter
+
+    // Sprites on this line, in fetch order
+    BYTE sprites[MAX_SPRITES_PER_LINE];
+    BYTE sprite_count;
+    BYTE next_sprite;                           // Next sprite in sprites[] to be fetched
+    bool sprite_pending;                        // A sprite starts at lx, pixel output stalls until it is fetched
+    BYTE sprite_dots;                           // Dots spent on the current sprite fetch
+
+    bool lcd_on;                                // The LCD was on at the last step
+} pixel_fifo;
+
+// Switches the instance's PPU engine, carrying the position within the current scanline across
+void SetPPUEngine(ppu_engine_types engine, GBCPU & CPU);
+
+// Runs the pixel FIFO engine for the given number of dots
+void ExecutePixelFIFO(BYTE cycles, GBCPU & CPU);
+
+#endif /* pixel_fifo.h */
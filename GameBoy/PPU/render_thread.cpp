@@ -0,0 +1,167 @@
+/*  Name:        render_thread.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the pipelined rendering mode for the PPU.
+                 The CPU thread captures the PPU registers for each scanline and
+                 pushes them, along with every VRAM/OAM write, through a single
+                 producer/single consumer ring. A dedicated render thread replays
+                 the writes into its own copy of video memory and draws the
+                 scanlines, taking pixel work off the emulation thread. Every
+                 emulator instance has a render thread of its own. */
+
+#include "render_thread.h"
+#include "context.h"
+
+
+/* Function: static void RenderThreadMain(render_thread_state * state)
+             Render thread loop. Applies queued video memory writes and
+             renders queued scanlines in order until stopped and drained. */
+static void RenderThreadMain(render_thread_state * state)
+{
+    ppu_video_memory mem;
+    mem.vram = state->vram;
+    mem.oam = state->oam;
+    mem.sprites = &state->sprites;
+    mem.layers = &state->layers;
+    mem.frame = state->frame;
+
+    unsigned int tail = state->queue_tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        // Sleep until the CPU thread queues more work, or exit once stopped with nothing left to do
+        if (tail == state->queue_head.load(std::memory_order_acquire))
+        {
+            if (state->running.load() == false)
+                break;
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->sleeping.store(true);
+            state->wakeup.wait(lock, [state, tail] { return (tail != state->queue_head.load()) ||
+                                                            (state->running.load() == false); });
+            state->sleeping.store(false);
+            continue;
+        }
+
+        const render_command & cmd = state->queue[tail & (RENDER_QUEUE_SIZE - 1)];
+        if (cmd.type == RENDER_CMD_LINE)
+            RenderScanline(cmd.regs, mem);
+        else if (cmd.addr >= SPRITE_TABLE_START)
+        {
+            state->oam[cmd.addr - SPRITE_TABLE_START] = cmd.data;
+            UpdateOAMIndex(state->sprites, cmd.addr, cmd.data);
+        }
+        else if (state->vram[cmd.addr - VRAM_START] != cmd.data)
+        {
+            state->vram[cmd.addr - VRAM_START] = cmd.data;
+            UpdateBackgroundCache(state->layers, cmd.addr);
+        }
+
+        // Release the slot. This also publishes the rendered pixels to FlushRenderThread
+        state->queue_tail.store(++tail, std::memory_order_release);
+    }
+}
+
+/* Function: static void WakeRenderThread(render_thread_state & state)
+             Wakes the render thread if it is waiting on an empty ring. */
+static void WakeRenderThread(render_thread_state & state)
+{
+    if (state.sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.wakeup.notify_one();
+    }
+}
+
+/* Function: static void PushRenderCommand(render_thread_state & state, const render_command & cmd)
+             Appends a command to the ring, waiting for a free slot if the
+             render thread has fallen a full ring behind. */
+static void PushRenderCommand(render_thread_state & state, const render_command & cmd)
+{
+    unsigned int head = state.queue_head.load(std::memory_order_relaxed);
+
+    while ((head - state.queue_tail.load(std::memory_order_acquire)) >= RENDER_QUEUE_SIZE)
+    {
+        WakeRenderThread(state);
+        std::this_thread::yield();
+    }
+
+    state.queue[head & (RENDER_QUEUE_SIZE - 1)] = cmd;
+    state.queue_head.store(head + 1);
+}
+
+void StartRenderThread(GBCPU & CPU)
+{
+    if (CPU.gb->render_thread != NULL)
+        return;
+
+    render_thread_state * state = new render_thread_state;
+
+    // Seed the render thread's video memory with what the CPU currently sees
+    memcpy(state->vram, &CPU.MEM[VRAM_START], sizeof(state->vram));
+    memcpy(state->oam, &CPU.MEM[SPRITE_TABLE_START], sizeof(state->oam));
+    ResetOAMIndex(state->sprites, state->oam);
+    ResetBackgroundCache(state->layers);
+    state->frame = &CPU.gb->frame;
+
+    state->queue_head.store(0);
+    state->queue_tail.store(0);
+    state->sleeping.store(false);
+    state->running.store(true);
+    state->thread = new std::thread(RenderThreadMain, state);
+
+    CPU.gb->render_thread = state;
+}
+
+void StopRenderThread(GBCPU & CPU)
+{
+    render_thread_state * state = CPU.gb->render_thread;
+    if (state == NULL)
+        return;
+
+    // Let the thread drain the ring, then wait for it to exit
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->running.store(false);
+        state->wakeup.notify_one();
+    }
+
+    state->thread->join();
+    delete state->thread;
+    delete state;
+
+    CPU.gb->render_thread = NULL;
+}
+
+void FlushRenderThread(GBCPU & CPU)
+{
+    render_thread_state * state = CPU.gb->render_thread;
+    if (state == NULL)
+        return;
+
+    WakeRenderThread(*state);
+    while (state->queue_tail.load(std::memory_order_acquire) != state->queue_head.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+}
+
+void QueueScanline(const ppu_line_registers & regs, GBCPU & CPU)
+{
+    render_command cmd;
+    cmd.type = RENDER_CMD_LINE;
+    cmd.data = 0;
+    cmd.addr = 0;
+    cmd.regs = regs;
+
+    PushRenderCommand(*CPU.gb->render_thread, cmd);
+    WakeRenderThread(*CPU.gb->render_thread);
+}
+
+void QueueVideoWrite(WORD addr, BYTE data, GBCPU & CPU)
+{
+    render_command cmd;
+    cmd.type = RENDER_CMD_WRITE;
+    cmd.data = data;
+    cmd.addr = addr;
+
+    PushRenderCommand(*CPU.gb->render_thread, cmd);
+}
@@ -0,0 +1,69 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include "GBPPU.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Number of entries in the scanline command ring. Must be a power of two.
+#define RENDER_QUEUE_SIZE 16384
+
+// Types of commands passed from the CPU thread to the render thread
+typedef enum render_command_types
+{
+    RENDER_CMD_LINE,     // Render a scanline using the attached registers
+    RENDER_CMD_WRITE     // Apply a VRAM/OAM write to the render thread's copy
+} render_command_types;
+
+// A single entry in the scanline command ring
+typedef struct render_command
+{
+    BYTE type;                 // render_command_types
+    BYTE data;                 // Byte written (RENDER_CMD_WRITE)
+    WORD addr;                 // Address written (RENDER_CMD_WRITE)
+    ppu_line_registers regs;   // Register snapshot (RENDER_CMD_LINE)
+} render_command;
+
+// The render thread of one emulator instance, with its own copy of video memory
+typedef struct render_thread_state
+{
+    // Scanline command ring. Only the CPU thread advances the head and only the render thread advances the tail
+    render_command queue[RENDER_QUEUE_SIZE];
+    std::atomic<unsigned int> queue_head;   // Next slot to be written by the CPU thread
+    std::atomic<unsigned int> queue_tail;   // Next slot to be read by the render thread
+
+    // The render thread's copy of video memory, kept in order with the scanlines through RENDER_CMD_WRITE
+    BYTE vram[VRAM_END - VRAM_START + 1];
+    BYTE oam[SPRITE_TABLE_END - SPRITE_TABLE_START + 1];
+    oam_index sprites;
+    bg_layer_cache layers;
+    frame_buffer * frame;                   // The instance's framebuffer, which scanlines are drawn into
+
+    // Thread management. The render thread sleeps on the condition variable when the ring is empty
+    std::thread * thread;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> running;
+} render_thread_state;
+
+// Starts the instance's render thread with a copy of the current VRAM/OAM contents.
+// Scanlines are queued for it instead of drawn in place from then on
+void StartRenderThread(GBCPU & CPU);
+
+// Drains the queue and stops the render thread. Rendering returns to the CPU thread
+void StopRenderThread(GBCPU & CPU);
+
+// Blocks until every queued scanline has been drawn into the pixel buffer
+void FlushRenderThread(GBCPU & CPU);
+
+// Queues a scanline to be rendered with the given register snapshot
+void QueueScanline(const ppu_line_registers & regs, GBCPU & CPU);
+
+// Queues a VRAM/OAM write so the render thread's copy of video memory stays in order with its scanlines
+void QueueVideoWrite(WORD addr, BYTE data, GBCPU & CPU);
+
+#endif /* render_thread.h */
@@ -0,0 +1,175 @@
+/*  Name:        color_convert.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains conversions of finished frames out of the
+                 pixel buffer: BT.601 YUV 4:2:0 for video encoders, and back to
+                 the 4 Game Boy shades for indexed-color consumers. */
+
+#include "color_convert.h"
+#include "simd.h"
+#include "GBPPU.h"
+
+// Fixed point BT.601 coefficients for R, G, B (x256)
+#define Y_R   66
+#define Y_G  129
+#define Y_B   25
+#define U_R  -38
+#define U_G  -74
+#define U_B  112
+#define V_R  112
+#define V_G  -94
+#define V_B  -18
+
+// Shade of every possible red value: the shade whose color is closest
+static BYTE shade_of[256];
+
+
+/* Function: static BYTE Average(BYTE a, BYTE b)
+             Rounded average of two bytes, the same as SSE2's pavgb. */
+static inline BYTE Average(BYTE a, BYTE b)
+{
+    return (BYTE)((a + b + 1) >> 1);
+}
+
+/* Function: static BYTE ToLuma(int r, int g, int b) / ToChroma(...)
+             BT.601 conversion of a single color. */
+static inline BYTE ToLuma(int r, int g, int b)
+{
+    return (BYTE)(((Y_R * r + Y_G * g + Y_B * b + 128) >> 8) + 16);
+}
+
+static inline BYTE ToChroma(int r, int g, int b, int coeff_r, int coeff_g, int coeff_b)
+{
+    return (BYTE)(((coeff_r * r + coeff_g * g + coeff_b * b + 128) >> 8) + 128);
+}
+
+#ifdef USE_SSE2
+/* Function: static __m128i WeightedSums(__m128i pixels, __m128i coeffs)
+             Returns coeff_r * R + coeff_g * G + coeff_b * B for each of 4
+             pixels in pixel buffer layout, as 4 32-bit lanes. */
+static inline __m128i WeightedSums(__m128i pixels, __m128i coeffs)
+{
+    __m128i zero = _mm_setzero_si128();
+
+    // (0 * A + cr * R) and (cg * G + cb * B) for each pixel, then add each pair
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coeffs);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coeffs);
+    lo = _mm_add_epi32(lo, _mm_srli_epi64(lo, 32));
+    hi = _mm_add_epi32(hi, _mm_srli_epi64(hi, 32));
+
+    // Pixel sums are now in lanes 0 and 2 of each half
+    return _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)),
+                              _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+/* Function: static __m128i FinishComponent(__m128i sums, int offset)
+             Rounds and scales 4 weighted sums and adds the component offset. */
+static inline __m128i FinishComponent(__m128i sums, int offset)
+{
+    sums = _mm_srai_epi32(_mm_add_epi32(sums, _mm_set1_epi32(128)), 8);
+    return _mm_add_epi32(sums, _mm_set1_epi32(offset));
+}
+
+/* Function: static __m128i AverageBlocks(const BYTE * row0, const BYTE * row1)
+             Averages 4 pixels of two rows down to 2 pixels of 2x2 blocks,
+             returned in the low 8 bytes. */
+static inline __m128i AverageBlocks(const BYTE * row0, const BYTE * row1)
+{
+    __m128i rows = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)row0), _mm_loadu_si128((const __m128i *)row1));
+    __m128i pairs = _mm_avg_epu8(rows, _mm_srli_si128(rows, 4));
+    return _mm_shuffle_epi32(pairs, _MM_SHUFFLE(3, 1, 2, 0));
+}
+#endif
+
+void ConvertFrameYUV420(const BYTE (*pixels)[160][4], BYTE * y_plane, BYTE * u_plane, BYTE * v_plane)
+{
+#ifdef USE_SSE2
+    __m128i y_coeffs = _mm_setr_epi16(0, Y_R, Y_G, Y_B, 0, Y_R, Y_G, Y_B);
+    __m128i u_coeffs = _mm_setr_epi16(0, U_R, U_G, U_B, 0, U_R, U_G, U_B);
+    __m128i v_coeffs = _mm_setr_epi16(0, V_R, V_G, V_B, 0, V_R, V_G, V_B);
+
+    // Luma, 16 pixels at a time
+    for (int y = 0; y < 144; ++y)
+    {
+        for (int x = 0; x < 160; x += 16)
+        {
+            __m128i sums[4];
+            for (int i = 0; i < 4; ++i)
+                sums[i] = FinishComponent(WeightedSums(_mm_loadu_si128((const __m128i *)pixels[y][x + i * 4]), y_coeffs), 16);
+
+            __m128i luma = _mm_packus_epi16(_mm_packs_epi32(sums[0], sums[1]), _mm_packs_epi32(sums[2], sums[3]));
+            _mm_storeu_si128((__m128i *)&y_plane[y * 160 + x], luma);
+        }
+    }
+
+    // Chroma, 8 blocks (16x2 pixels) at a time
+    for (int y = 0; y < 72; ++y)
+    {
+        for (int x = 0; x < 80; x += 8)
+        {
+            __m128i u_sums[2];
+            __m128i v_sums[2];
+            for (int i = 0; i < 2; ++i)
+            {
+                int px = (x + i * 4) * 2;
+                __m128i blocks = _mm_unpacklo_epi64(AverageBlocks(pixels[y * 2][px], pixels[y * 2 + 1][px]),
+                                                    AverageBlocks(pixels[y * 2][px + 4], pixels[y * 2 + 1][px + 4]));
+                u_sums[i] = FinishComponent(WeightedSums(blocks, u_coeffs), 128);
+                v_sums[i] = FinishComponent(WeightedSums(blocks, v_coeffs), 128);
+            }
+
+            __m128i u = _mm_packs_epi32(u_sums[0], u_sums[1]);
+            __m128i v = _mm_packs_epi32(v_sums[0], v_sums[1]);
+            _mm_storel_epi64((__m128i *)&u_plane[y * 80 + x], _mm_packus_epi16(u, u));
+            _mm_storel_epi64((__m128i *)&v_plane[y * 80 + x], _mm_packus_epi16(v, v));
+        }
+    }
+#else
+    for (int y = 0; y < 144; ++y)
+        for (int x = 0; x < 160; ++x)
+            y_plane[y * 160 + x] = ToLuma(pixels[y][x][1], pixels[y][x][2], pixels[y][x][3]);
+
+    for (int y = 0; y < 72; ++y)
+    {
+        for (int x = 0; x < 80; ++x)
+        {
+            // Average each 2x2 block the same way the SIMD path does: rows first, then columns
+            BYTE rgb[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                BYTE left  = Average(pixels[y * 2][x * 2][c + 1],     pixels[y * 2 + 1][x * 2][c + 1]);
+                BYTE right = Average(pixels[y * 2][x * 2 + 1][c + 1], pixels[y * 2 + 1][x * 2 + 1][c + 1]);
+                rgb[c] = Average(left, right);
+            }
+
+            u_plane[y * 80 + x] = ToChroma(rgb[0], rgb[1], rgb[2], U_R, U_G, U_B);
+            v_plane[y * 80 + x] = ToChroma(rgb[0], rgb[1], rgb[2], V_R, V_G, V_B);
+        }
+    }
+#endif
+}
+
+void InitColorConversion()
+{
+    for (int value = 0; value < 256; ++value)
+    {
+        int best_distance = 256;
+        for (BYTE shade = 0; shade < 4; ++shade)
+        {
+            int distance = abs(value - getShadeColor(shade).r);
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                shade_of[value] = shade;
+            }
+        }
+    }
+}
+
+void ConvertFrameIndexed(const BYTE (*pixels)[160][4], BYTE * indices)
+{
+    for (int y = 0; y < 144; ++y)
+        for (int x = 0; x < 160; ++x)
+            indices[y * 160 + x] = shade_of[pixels[y][x][1]];
+}
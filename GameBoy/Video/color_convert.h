@@ -0,0 +1,20 @@
+#ifndef COLOR_CONVERT_H
+#define COLOR_CONVERT_H
+
+#include "gameboy.h"
+
+// Size of the planes of a 160x144 YUV 4:2:0 frame
+#define YUV_Y_SIZE      (160 * 144)
+#define YUV_UV_SIZE     (80 * 72)
+#define YUV_FRAME_SIZE  (YUV_Y_SIZE + 2 * YUV_UV_SIZE)
+
+// Builds the lookup tables the conversions use. Called once at startup, before any frame is converted
+void InitColorConversion();
+
+// Converts a frame from the pixel buffer into BT.601 YUV 4:2:0 planes. Chroma is averaged over each 2x2 block
+void ConvertFrameYUV420(const BYTE (*pixels)[160][4], BYTE * y_plane, BYTE * u_plane, BYTE * v_plane);
+
+// Converts a frame from the pixel buffer back into shades, one byte per pixel: 0 = white ... 3 = black
+void ConvertFrameIndexed(const BYTE (*pixels)[160][4], BYTE * indices);
+
+#endif /* color_convert.h */
@@ -0,0 +1,371 @@
+/*  Name:        frame_capture.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains frame hashing and screenshots, for checking
+                 the screen in automated tests. Frames are reduced to their
+                 shades first, so hashes and screenshots do not depend on the
+                 framebuffer format. The hash is cheap enough to take on every
+                 frame. */
+
+#include "frame_capture.h"
+#include "framebuffer.h"
+#include "color_convert.h"
+#include "simd.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+
+// Hash constants
+#define HASH_PRIME32    0x9E3779B1ULL
+#define HASH_PRIME64_1  0x9E3779B185EBCA87ULL
+#define HASH_PRIME64_2  0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME64_3  0x165667B19E3779F9ULL
+
+// A screenshot waiting for its frame
+typedef struct screenshot_request
+{
+    unsigned int frame;
+    std::string path;
+} screenshot_request;
+
+// Define frame capture variables. Several emulator instances may complete frames at once
+static FILE * hash_log = NULL;
+static std::vector<screenshot_request> screenshot_requests;
+static std::mutex capture_mutex;
+
+// Secret mixed into each of the 8 64-bit lanes of the hash
+static const unsigned long long hash_key[8] =
+{
+    0x5C85D78CA23F21C8ULL, 0xBBFF3A0A02292A32ULL, 0x27B9CBF8D46FCE70ULL, 0x4BD2061D0D8814D8ULL,
+    0x83D86DDE6737500BULL, 0xCA77AFD1281F1497ULL, 0x0BDBE4BB38661B76ULL, 0x44C5443AA29F743FULL
+};
+
+
+/* Function: static void HashStripes(const BYTE * data, int stripes, unsigned long long acc[8])
+             Accumulates 64 byte stripes into 8 lanes, as XXH3 does: each
+             lane adds the product of the two halves of its word mixed with
+             the key, plus its neighbor's word. The lanes are scrambled after
+             every stripe so that the order of the stripes matters. */
+static void HashStripes(const BYTE * data, int stripes, unsigned long long acc[8])
+{
+#ifdef USE_SSE2
+    __m128i lanes[4];
+    __m128i keys[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        lanes[i] = _mm_loadu_si128((const __m128i *)&acc[i * 2]);
+        keys[i] = _mm_loadu_si128((const __m128i *)&hash_key[i * 2]);
+    }
+    __m128i prime = _mm_set1_epi32((int)HASH_PRIME32);
+
+    for (int stripe = 0; stripe < stripes; ++stripe)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128i words = _mm_loadu_si128((const __m128i *)&data[stripe * 64 + i * 16]);
+            __m128i mixed = _mm_xor_si128(words, keys[i]);
+            __m128i product = _mm_mul_epu32(mixed, _mm_shuffle_epi32(mixed, _MM_SHUFFLE(2, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2));
+            __m128i lane = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+
+            // Scramble: (lane ^ (lane >> 47) ^ key) * prime, multiplying both 32-bit halves
+            lane = _mm_xor_si128(_mm_xor_si128(lane, _mm_srli_epi64(lane, 47)), keys[i]);
+            lanes[i] = _mm_add_epi64(_mm_mul_epu32(lane, prime),
+                                     _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(lane, 32), prime), 32));
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+        _mm_storeu_si128((__m128i *)&acc[i * 2], lanes[i]);
+#else
+    for (int stripe = 0; stripe < stripes; ++stripe)
+    {
+        unsigned long long words[8];
+        memcpy(words, &data[stripe * 64], 64);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            unsigned long long mixed = words[i] ^ hash_key[i];
+            unsigned long long lane = acc[i] + (mixed & 0xFFFFFFFFULL) * (mixed >> 32) + words[i ^ 1];
+
+            lane = lane ^ (lane >> 47) ^ hash_key[i];
+            acc[i] = lane * HASH_PRIME32;
+        }
+    }
+#endif
+}
+
+/* Function: static const BYTE (*GetFrameShades(const frame_buffer & frame, BYTE (*shades)[160]))[160]
+             Returns the shades of the frame in a framebuffer, converting
+             them into the given buffer if the frame is not indexed. */
+static const BYTE (*GetFrameShades(const frame_buffer & frame, BYTE (*shades)[160]))[160]
+{
+    if (framebuffer_format == FRAMEBUFFER_INDEXED)
+        return frame.index_buffer;
+
+    ConvertFrameIndexed(frame.pixel_buffer, shades[0]);
+    return shades;
+}
+
+/* Function: static void WriteBigEndian(BYTE * out, unsigned int value)
+             Writes a 32-bit value most significant byte first, as PNG stores them. */
+static void WriteBigEndian(BYTE * out, unsigned int value)
+{
+    out[0] = (BYTE)(value >> 24);
+    out[1] = (BYTE)(value >> 16);
+    out[2] = (BYTE)(value >> 8);
+    out[3] = (BYTE)value;
+}
+
+/* Function: static void WritePNGChunk(FILE * file, const char * type, const BYTE * data, unsigned int size)
+             Writes a PNG chunk: length, type, data and the CRC of type and data. */
+static void WritePNGChunk(FILE * file, const char * type, const BYTE * data, unsigned int size)
+{
+    static unsigned int crc_table[256];
+    if (crc_table[1] == 0)
+    {
+        for (unsigned int n = 0; n < 256; ++n)
+        {
+            unsigned int c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            crc_table[n] = c;
+        }
+    }
+
+    unsigned int crc = 0xFFFFFFFF;
+    for (int i = 0; i < 4; ++i)
+        crc = crc_table[(crc ^ (BYTE)type[i]) & 0xFF] ^ (crc >> 8);
+    for (unsigned int i = 0; i < size; ++i)
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    BYTE header[8];
+    WriteBigEndian(header, size);
+    memcpy(&header[4], type, 4);
+
+    BYTE footer[4];
+    WriteBigEndian(footer, crc ^ 0xFFFFFFFF);
+
+    fwrite(header, 1, 8, file);
+    fwrite(data, 1, size, file);
+    fwrite(footer, 1, 4, file);
+}
+
+/* Function: static bool WritePNG(const char * path, const BYTE (*shades)[160])
+             Writes a 2-bit palette PNG. The image data is small enough (144
+             rows of 1 filter byte + 40 bytes) to be stored uncompressed in a
+             single deflate block, so no compression library is needed. */
+static bool WritePNG(const char * path, const BYTE (*shades)[160])
+{
+    FILE * file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        printf("Unable to create screenshot file: %s\n", path);
+        return false;
+    }
+
+    static const BYTE signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, 8, file);
+
+    // 160x144, 2 bits per pixel, palette colors
+    BYTE header[13] = { 0 };
+    WriteBigEndian(&header[0], 160);
+    WriteBigEndian(&header[4], 144);
+    header[8] = 2;
+    header[9] = 3;
+    WritePNGChunk(file, "IHDR", header, 13);
+
+    BYTE palette[4 * 3];
+    for (int shade = 0; shade < 4; ++shade)
+        palette[shade * 3] = palette[shade * 3 + 1] = palette[shade * 3 + 2] = shade_levels[shade];
+    WritePNGChunk(file, "PLTE", palette, 4 * 3);
+
+    // Rows of packed pixels, each behind a "no filter" byte
+    BYTE packed[PACKED_FRAME_SIZE];
+    PackIndexedFrame(shades, packed);
+
+    const unsigned int raw_size = 144 * (1 + 40);
+    BYTE image[2 + 5 + raw_size + 4];
+    BYTE * raw = &image[7];
+    for (int y = 0; y < 144; ++y)
+    {
+        raw[y * 41] = 0;
+        memcpy(&raw[y * 41 + 1], &packed[y * 40], 40);
+    }
+
+    // zlib header, then a single final stored block, then the Adler-32 of the raw data
+    image[0] = 0x78;
+    image[1] = 0x01;
+    image[2] = 0x01;
+    image[3] = (BYTE)(raw_size & 0xFF);
+    image[4] = (BYTE)(raw_size >> 8);
+    image[5] = (BYTE)(~raw_size & 0xFF);
+    image[6] = (BYTE)((~raw_size >> 8) & 0xFF);
+
+    unsigned int adler_a = 1;
+    unsigned int adler_b = 0;
+    for (unsigned int i = 0; i < raw_size; ++i)
+    {
+        adler_a = (adler_a + raw[i]) % 65521;
+        adler_b = (adler_b + adler_a) % 65521;
+    }
+    WriteBigEndian(&image[7 + raw_size], (adler_b << 16) | adler_a);
+
+    WritePNGChunk(file, "IDAT", image, sizeof(image));
+    WritePNGChunk(file, "IEND", NULL, 0);
+
+    bool written = (ferror(file) == 0);
+    fclose(file);
+    return written;
+}
+
+/* Function: static bool WritePPM(const char * path, const BYTE (*shades)[160])
+             Writes a binary (P6) PPM. */
+static bool WritePPM(const char * path, const BYTE (*shades)[160])
+{
+    FILE * file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        printf("Unable to create screenshot file: %s\n", path);
+        return false;
+    }
+
+    fprintf(file, "P6\n160 144\n255\n");
+
+    BYTE row[160 * 3];
+    for (int y = 0; y < 144; ++y)
+    {
+        for (int x = 0; x < 160; ++x)
+            row[x * 3] = row[x * 3 + 1] = row[x * 3 + 2] = shade_levels[shades[y][x] & 0x03];
+
+        fwrite(row, 1, sizeof(row), file);
+    }
+
+    bool written = (ferror(file) == 0);
+    fclose(file);
+    return written;
+}
+
+/* Function: static bool SaveScreenshot(const char * path, const BYTE (*shades)[160])
+             Picks the screenshot format by the file extension. */
+static bool SaveScreenshot(const char * path, const BYTE (*shades)[160])
+{
+    size_t length = strlen(path);
+    if ((length >= 4) && ((strcmp(&path[length - 4], ".ppm") == 0) || (strcmp(&path[length - 4], ".PPM") == 0)))
+        return WritePPM(path, shades);
+
+    return WritePNG(path, shades);
+}
+
+unsigned long long HashFrameShades(const BYTE (*shades)[160])
+{
+    // 4 shades per byte: 90 stripes of 64 bytes
+    BYTE packed[PACKED_FRAME_SIZE];
+    PackIndexedFrame(shades, packed);
+
+    unsigned long long acc[8] = { HASH_PRIME32, HASH_PRIME64_1, HASH_PRIME64_2, HASH_PRIME64_3,
+                                  HASH_PRIME64_1 ^ HASH_PRIME64_2, HASH_PRIME64_2 ^ HASH_PRIME64_3,
+                                  HASH_PRIME64_3 ^ HASH_PRIME32, HASH_PRIME64_1 ^ HASH_PRIME32 };
+    HashStripes(packed, PACKED_FRAME_SIZE / 64, acc);
+
+    // Merge the lanes and let every bit affect every other one
+    unsigned long long hash = PACKED_FRAME_SIZE * HASH_PRIME64_1;
+    for (int i = 0; i < 8; ++i)
+        hash = (hash ^ (acc[i] * HASH_PRIME64_2)) * HASH_PRIME64_1;
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+unsigned long long GetFrameHash(const frame_buffer & frame)
+{
+    BYTE shades[144][160];
+    return HashFrameShades(GetFrameShades(frame, shades));
+}
+
+bool SaveScreenshot(const char * path, const frame_buffer & frame)
+{
+    BYTE shades[144][160];
+    return SaveScreenshot(path, GetFrameShades(frame, shades));
+}
+
+bool StartFrameHashLog(const char * path)
+{
+    std::lock_guard<std::mutex> lock(capture_mutex);
+
+    if (hash_log != NULL)
+        fclose(hash_log);
+
+    hash_log = fopen(path, "w");
+    if (hash_log == NULL)
+    {
+        printf("Unable to create frame hash file: %s\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+void RequestScreenshot(unsigned int frame, const char * path)
+{
+    std::lock_guard<std::mutex> lock(capture_mutex);
+
+    screenshot_request request;
+    request.frame = frame;
+    request.path = path;
+    screenshot_requests.push_back(request);
+}
+
+bool IsFrameCaptureActive()
+{
+    std::lock_guard<std::mutex> lock(capture_mutex);
+
+    return (hash_log != NULL) || (screenshot_requests.empty() == false);
+}
+
+void CaptureFrame(const frame_buffer & frame, unsigned int number)
+{
+    if (IsFrameCaptureActive() == false)
+        return;
+
+    // Shades are taken outside the lock, from this instance's own frame
+    BYTE converted[144][160];
+    const BYTE (*shades)[160] = GetFrameShades(frame, converted);
+
+    std::lock_guard<std::mutex> lock(capture_mutex);
+
+    if (hash_log != NULL)
+        fprintf(hash_log, "%u %016llx\n", number, HashFrameShades(shades));
+
+    for (size_t i = 0; i < screenshot_requests.size(); )
+    {
+        if (screenshot_requests[i].frame == number)
+        {
+            SaveScreenshot(screenshot_requests[i].path.c_str(), shades);
+            screenshot_requests.erase(screenshot_requests.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void StopFrameCapture()
+{
+    std::lock_guard<std::mutex> lock(capture_mutex);
+
+    if (hash_log != NULL)
+        fclose(hash_log);
+
+    hash_log = NULL;
+    screenshot_requests.clear();
+}
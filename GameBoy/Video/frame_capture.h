@@ -0,0 +1,33 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include "gameboy.h"
+#include "framebuffer.h"
+
+// Returns a 64-bit hash of a frame of shades
+unsigned long long HashFrameShades(const BYTE (*shades)[160]);
+
+// Returns a 64-bit hash of the shades of the frame in a framebuffer. The hash is the same
+// whichever framebuffer format the PPU draws into
+unsigned long long GetFrameHash(const frame_buffer & frame);
+
+// Writes the frame in a framebuffer to a 2-bit grayscale PNG, or to a binary PPM if the path
+// ends in .ppm. Returns false if the file could not be written
+bool SaveScreenshot(const char * path, const frame_buffer & frame);
+
+// Writes the hash of every completed frame to a text file, one "<frame number> <hash>" line per frame
+bool StartFrameHashLog(const char * path);
+
+// Saves a screenshot of the given frame number once the PPU completes it
+void RequestScreenshot(unsigned int frame, const char * path);
+
+// Returns true if completed frames need to be looked at by CaptureFrame
+bool IsFrameCaptureActive();
+
+// Called when the PPU completes frame number N (counting from 0): writes its hash and any requested screenshot
+void CaptureFrame(const frame_buffer & frame, unsigned int number);
+
+// Closes the hash log
+void StopFrameCapture();
+
+#endif /* frame_capture.h */
@@ -0,0 +1,59 @@
+/*  Name:        framebuffer.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the indexed framebuffer. Instead of colors,
+                 the PPU can draw each pixel's shade (one byte per pixel, a
+                 quarter of pixel_buffer's size), leaving conversion to colors
+                 to whichever video sink actually needs them. */
+
+#include "framebuffer.h"
+#include "simd.h"
+
+// Define framebuffer variables
+framebuffer_formats framebuffer_format = FRAMEBUFFER_RGBA;
+const BYTE shade_levels[4] = { 255, 125, 60, 0 };
+
+
+void ExpandIndexedFrame(const BYTE (*shades)[160], BYTE (*pixels)[160][4])
+{
+    // Each shade's color as a whole pixel buffer entry
+    Uint32 colors[4];
+    for (int shade = 0; shade < 4; ++shade)
+    {
+        BYTE color[4] = { 0, shade_levels[shade], shade_levels[shade], shade_levels[shade] };
+        memcpy(&colors[shade], color, 4);
+    }
+
+    Uint32 * out = (Uint32 *)pixels;
+    const BYTE * in = shades[0];
+    for (int i = 0; i < 160 * 144; ++i)
+        out[i] = colors[in[i] & 0x03];
+}
+
+void PackIndexedFrame(const BYTE (*shades)[160], BYTE * packed)
+{
+    const BYTE * in = shades[0];
+
+#ifdef USE_SSE2
+    // 64 pixels at a time. Each 32-bit lane holds 4 pixels, which are gathered into its low byte
+    for (int i = 0; i < 160 * 144; i += 64)
+    {
+        __m128i lanes[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            __m128i pixels = _mm_loadu_si128((const __m128i *)&in[i + j * 16]);
+            lanes[j] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 6), _mm_set1_epi32(0xC0)),
+                                                 _mm_and_si128(_mm_srli_epi32(pixels, 4), _mm_set1_epi32(0x30))),
+                                    _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 14), _mm_set1_epi32(0x0C)),
+                                                 _mm_and_si128(_mm_srli_epi32(pixels, 24), _mm_set1_epi32(0x03))));
+        }
+
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(lanes[0], lanes[1]), _mm_packs_epi32(lanes[2], lanes[3]));
+        _mm_storeu_si128((__m128i *)&packed[i / 4], bytes);
+    }
+#else
+    for (int i = 0; i < 160 * 144; i += 4)
+        packed[i / 4] = ((in[i] & 0x03) << 6) | ((in[i + 1] & 0x03) << 4) | ((in[i + 2] & 0x03) << 2) | (in[i + 3] & 0x03);
+#endif
+}
@@ -0,0 +1,50 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "gameboy.h"
+
+// Size of a 160x144 frame of shades packed 4 pixels per byte
+#define PACKED_FRAME_SIZE  (160 * 144 / 4)
+
+// What the PPU draws into
+typedef enum framebuffer_formats
+{
+    FRAMEBUFFER_RGBA,     // Colors, in pixel_buffer
+    FRAMEBUFFER_INDEXED   // Shades (0 = white ... 3 = black), one byte per pixel, in index_buffer
+} framebuffer_formats;
+
+// The frame a PPU draws into. Only the buffer of the current format is drawn
+typedef struct frame_buffer
+{
+    BYTE pixel_buffer[144][160][4]; // Alpha-Red-Green-Blue for SDL texture copying, in FRAMEBUFFER_RGBA mode
+    BYTE index_buffer[144][160];    // Shade of each pixel, in FRAMEBUFFER_INDEXED mode
+} frame_buffer;
+
+/* Framebuffer state (framebuffer.cpp) */
+extern framebuffer_formats framebuffer_format; // Where the PPU draws the frame
+extern const BYTE shade_levels[4];             // Gray level of each shade, for all of R, G and B
+
+/* Function: void SetFramePixel(frame_buffer & frame, BYTE line, BYTE x, BYTE shade)
+             Draws a pixel of the current frame, as a shade, into whichever
+             framebuffer the PPU is drawing into. */
+inline void SetFramePixel(frame_buffer & frame, BYTE line, BYTE x, BYTE shade)
+{
+    if (framebuffer_format == FRAMEBUFFER_INDEXED)
+    {
+        frame.index_buffer[line][x] = shade;
+    }
+    else
+    {
+        frame.pixel_buffer[line][x][1] = shade_levels[shade];
+        frame.pixel_buffer[line][x][2] = shade_levels[shade];
+        frame.pixel_buffer[line][x][3] = shade_levels[shade];
+    }
+}
+
+// Converts a frame of shades into colors, in pixel buffer layout
+void ExpandIndexedFrame(const BYTE (*shades)[160], BYTE (*pixels)[160][4]);
+
+// Packs a frame of shades 4 pixels per byte, leftmost pixel in the top 2 bits
+void PackIndexedFrame(const BYTE (*shades)[160], BYTE * packed);
+
+#endif /* framebuffer.h */
@@ -0,0 +1,256 @@
+/*  Name:        recorder.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the video recorder. Each frame completed
+                 by the PPU is converted on the emulation thread and pushed
+                 into a bounded queue. Emulation threads take turns pushing
+                 frames, and a single writer thread pops them and writes them
+                 to disk, so emulation never waits on file I/O. Frames that were
+                 skipped or left unchanged are recorded as a copy of the last
+                 frame, so the video keeps the Game Boy's frame rate. */
+
+#include "recorder.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// A converted frame waiting to be written
+typedef struct recorded_frame
+{
+    BYTE data[YUV_FRAME_SIZE]; // Y, U and V planes, or 160x144 shades, unpacked or packed
+} recorded_frame;
+
+// Define recorder variables
+bool recorder_enabled = false;
+
+// Frame queue. Only the thread holding recorder_post_mutex advances the head and only the writer thread advances the tail
+static recorded_frame * recorder_queue = NULL;
+static std::atomic<unsigned int> recorder_queue_head(0);
+static std::atomic<unsigned int> recorder_queue_tail(0);
+static unsigned int recorder_dropped_frames = 0;
+static bool recorder_has_frame = false;
+static std::mutex recorder_post_mutex; // Held while a frame is queued, so instances recording from several threads take turns
+
+// Output
+static FILE * recorder_file = NULL;
+static recorder_formats recorder_format;
+
+// Thread management. The writer thread sleeps on the condition variable when the queue is empty
+static std::thread * recorder_thread = NULL;
+static std::mutex recorder_mutex;
+static std::condition_variable recorder_wakeup;
+static std::atomic<bool> recorder_thread_sleeping(false);
+static std::atomic<bool> recorder_thread_running(false);
+
+
+/* Function: static void RecorderThreadMain()
+             Writer thread loop. Writes queued frames in order until stopped and drained. */
+static void RecorderThreadMain()
+{
+    unsigned int tail = recorder_queue_tail.load(std::memory_order_relaxed);
+    size_t frame_size = YUV_FRAME_SIZE;
+    if (recorder_format == RECORD_INDEXED)
+        frame_size = YUV_Y_SIZE;
+    else if (recorder_format == RECORD_PACKED)
+        frame_size = PACKED_FRAME_SIZE;
+
+    while (true)
+    {
+        if (tail == recorder_queue_head.load(std::memory_order_acquire))
+        {
+            if (recorder_thread_running.load() == false)
+                break;
+
+            std::unique_lock<std::mutex> lock(recorder_mutex);
+            recorder_thread_sleeping.store(true);
+            recorder_wakeup.wait(lock, [tail] { return (tail != recorder_queue_head.load()) ||
+                                                       (recorder_thread_running.load() == false); });
+            recorder_thread_sleeping.store(false);
+            continue;
+        }
+
+        if (recorder_format == RECORD_Y4M)
+            fputs("FRAME\n", recorder_file);
+
+        fwrite(recorder_queue[tail & (RECORDER_QUEUE_SIZE - 1)].data, 1, frame_size, recorder_file);
+
+        // Release the slot
+        recorder_queue_tail.store(++tail, std::memory_order_release);
+    }
+}
+
+bool StartRecorder(const char * path, recorder_formats format)
+{
+    if (recorder_enabled)
+        return true;
+
+    recorder_file = fopen(path, "wb");
+    if (recorder_file == NULL)
+    {
+        printf("Unable to create recording file: %s\n", path);
+        return false;
+    }
+
+    // 160x144, progressive, square pixels, 4194304 / 70224 (59.73) frames per second
+    recorder_format = format;
+    if (format == RECORD_Y4M)
+        fputs("YUV4MPEG2 W160 H144 F4194304:70224 Ip A1:1 C420jpeg\n", recorder_file);
+
+    recorder_queue = new recorded_frame[RECORDER_QUEUE_SIZE];
+    recorder_queue_head.store(0);
+    recorder_queue_tail.store(0);
+    recorder_dropped_frames = 0;
+    recorder_has_frame = false;
+
+    recorder_thread_running.store(true);
+    recorder_thread = new std::thread(RecorderThreadMain);
+
+    recorder_enabled = true;
+    return true;
+}
+
+void StopRecorder()
+{
+    // Wait for any frame being queued, and keep new ones out
+    std::lock_guard<std::mutex> post_lock(recorder_post_mutex);
+    if (recorder_enabled == false)
+        return;
+
+    // Let the thread drain the queue, then wait for it to exit
+    {
+        std::lock_guard<std::mutex> lock(recorder_mutex);
+        recorder_thread_running.store(false);
+        recorder_wakeup.notify_one();
+    }
+
+    recorder_thread->join();
+    delete recorder_thread;
+    recorder_thread = NULL;
+
+    fclose(recorder_file);
+    recorder_file = NULL;
+
+    delete[] recorder_queue;
+    recorder_queue = NULL;
+
+    if (recorder_dropped_frames != 0)
+        printf("Recording dropped %u frames\n", recorder_dropped_frames);
+
+    recorder_enabled = false;
+}
+
+/* Function: static BYTE * AcquireSlot()
+             Returns the queue slot for the next frame, or NULL if the writer is
+             a whole queue behind and the frame has to be dropped. Called with
+             recorder_post_mutex held. */
+static BYTE * AcquireSlot()
+{
+    unsigned int head = recorder_queue_head.load(std::memory_order_relaxed);
+    if ((head - recorder_queue_tail.load(std::memory_order_acquire)) >= RECORDER_QUEUE_SIZE)
+    {
+        ++recorder_dropped_frames;
+        return NULL;
+    }
+
+    return recorder_queue[head & (RECORDER_QUEUE_SIZE - 1)].data;
+}
+
+/* Function: static void PushSlot()
+             Hands the slot returned by AcquireSlot to the writer thread. */
+static void PushSlot()
+{
+    recorder_has_frame = true;
+    recorder_queue_head.store(recorder_queue_head.load(std::memory_order_relaxed) + 1);
+
+    if (recorder_thread_sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(recorder_mutex);
+        recorder_wakeup.notify_one();
+    }
+}
+
+void RecordFrame(const BYTE (*pixels)[160][4])
+{
+    std::lock_guard<std::mutex> post_lock(recorder_post_mutex);
+    if (recorder_enabled == false)
+        return;
+
+    BYTE * data = AcquireSlot();
+    if (data == NULL)
+        return;
+
+    if (recorder_format == RECORD_Y4M)
+    {
+        ConvertFrameYUV420(pixels, data, data + YUV_Y_SIZE, data + YUV_Y_SIZE + YUV_UV_SIZE);
+    }
+    else if (recorder_format == RECORD_INDEXED)
+    {
+        ConvertFrameIndexed(pixels, data);
+    }
+    else
+    {
+        BYTE shades[144][160];
+        ConvertFrameIndexed(pixels, shades[0]);
+        PackIndexedFrame(shades, data);
+    }
+
+    PushSlot();
+}
+
+void RecordIndexedFrame(const BYTE (*shades)[160])
+{
+    std::lock_guard<std::mutex> post_lock(recorder_post_mutex);
+    if (recorder_enabled == false)
+        return;
+
+    BYTE * data = AcquireSlot();
+    if (data == NULL)
+        return;
+
+    if (recorder_format == RECORD_Y4M)
+    {
+        BYTE pixels[144][160][4];
+        ExpandIndexedFrame(shades, pixels);
+        ConvertFrameYUV420(pixels, data, data + YUV_Y_SIZE, data + YUV_Y_SIZE + YUV_UV_SIZE);
+    }
+    else if (recorder_format == RECORD_INDEXED)
+    {
+        memcpy(data, shades, YUV_Y_SIZE);
+    }
+    else
+    {
+        PackIndexedFrame(shades, data);
+    }
+
+    PushSlot();
+}
+
+bool RecordRepeatedFrame()
+{
+    std::lock_guard<std::mutex> post_lock(recorder_post_mutex);
+    if (recorder_enabled == false)
+        return true;
+
+    if (recorder_has_frame == false)
+        return false;
+
+    BYTE * data = AcquireSlot();
+    if (data == NULL)
+        return true;
+
+    // The previous slot is only reused once the head comes all the way around, so it still holds the last frame
+    unsigned int head = recorder_queue_head.load(std::memory_order_relaxed);
+    memcpy(data, recorder_queue[(head - 1) & (RECORDER_QUEUE_SIZE - 1)].data, YUV_FRAME_SIZE);
+
+    PushSlot();
+    return true;
+}
+
+unsigned int GetRecorderDroppedFrames()
+{
+    std::lock_guard<std::mutex> post_lock(recorder_post_mutex);
+    return recorder_dropped_frames;
+}
@@ -0,0 +1,43 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "gameboy.h"
+#include "color_convert.h"
+#include "framebuffer.h"
+
+// Number of frames that can wait for the writer thread. Must be a power of two.
+// Frames arriving while the queue is full are dropped rather than stalling emulation
+#define RECORDER_QUEUE_SIZE  64
+
+// Recording output formats
+typedef enum recorder_formats
+{
+    RECORD_Y4M,          // YUV4MPEG2 stream, 4:2:0, at the Game Boy's 59.73 frames per second
+    RECORD_INDEXED,      // Raw stream of 160x144 bytes per frame, one shade (0 - 3) per pixel
+    RECORD_PACKED        // Raw stream of 160x144 / 4 bytes per frame, 4 shades per byte, leftmost pixel in the top 2 bits
+} recorder_formats;
+
+/* Recorder state (recorder.cpp) */
+extern bool recorder_enabled; // Frames completed by the PPU are recorded
+
+// Opens the output file and starts the writer thread. Returns false if the file could not be created
+bool StartRecorder(const char * path, recorder_formats format);
+
+// Writes out every queued frame, stops the writer thread and closes the file
+void StopRecorder();
+
+// Converts a completed frame and queues it for the writer thread. Instances on
+// several threads may record at once; their frames are interleaved in one file
+void RecordFrame(const BYTE (*pixels)[160][4]);
+
+// Queues a completed frame drawn into the index buffer
+void RecordIndexedFrame(const BYTE (*shades)[160]);
+
+// Queues the last recorded frame again, for a frame the PPU did not redraw.
+// Returns false if nothing has been recorded yet
+bool RecordRepeatedFrame();
+
+// Returns the number of frames dropped because the writer thread fell behind
+unsigned int GetRecorderDroppedFrames();
+
+#endif /* recorder.h */
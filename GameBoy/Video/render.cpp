@@ -6,15 +6,14 @@
                  of the Gameboy emulator. */
 
 #include "render.h"
-
-
-// Pixel Buffer follows the Alpha-Red-Green-Blue format for SDL texture to render copying
-BYTE pixel_buffer[144][160][4]; // 144 px tall, 160 px wide, 4-bytes for color
+#include "context.h"
 
 
 // Renders the Nintendo scrolling graphic
-void getIntroScreen(GBCPU cpu)
+void getIntroScreen(GBCPU & cpu)
 {
+    BYTE (*pixel_buffer)[160][4] = cpu.gb->frame.pixel_buffer;
+
     // The Nintendo logo in $104 - $133 is not encoded, each bit 
     // refers to a colored pixel or not.
 
@@ -40,8 +39,8 @@ void getIntroScreen(GBCPU cpu)
         // X axis
         for (int x = 0; x < 12; ++x)
         {
-            logo_map[x][y*2] = cpu.MEM[index++];
-            logo_map[x][y*2 + 1] = cpu.MEM[index++];
+            logo_map[x][y*2] = cpu.readByte(index++);
+            logo_map[x][y*2 + 1] = cpu.readByte(index++);
         }
     }
 
@@ -134,9 +133,9 @@ void getIntroScreen(GBCPU cpu)
 }
 
 // Renders the GameBoy video buffer (256x256)
-void renderPixelBuffer(SDL_Renderer * renderer, SDL_Texture * texture)
+void renderPixelBuffer(SDL_Renderer * renderer, SDL_Texture * texture, const BYTE (*pixels)[160][4])
 {
-    SDL_UpdateTexture(texture, NULL, pixel_buffer, 160 * sizeof(Uint32)); // Last parameter is the size of one full row in the display
+    SDL_UpdateTexture(texture, NULL, pixels, 160 * sizeof(Uint32)); // Last parameter is the size of one full row in the display
 
     //for (int y = 0; y < 144; ++y)
     //{
@@ -147,6 +146,12 @@ void renderPixelBuffer(SDL_Renderer * renderer, SDL_Texture * texture)
     //}
 }
 
+// Renders an upscaled copy of the video buffer
+void renderScaledBuffer(SDL_Renderer * renderer, SDL_Texture * texture, const BYTE * pixels, int width)
+{
+    SDL_UpdateTexture(texture, NULL, pixels, width * sizeof(Uint32));
+}
+
 // Renders a quad at cell (x, y) with dimensions CELL_LENGTH
 void renderPixel(int x, int y, SDL_Renderer * renderer, pixel pixel)
 {
@@ -7,10 +7,13 @@
 //extern pixel pixel_buffer[160][144];
 
 // Renders the Nintendo scrolling graphic
-void getIntroScreen(GBCPU cpu);
+void getIntroScreen(GBCPU & cpu);
 
 // Renders entire GameBoy video buffer
-void renderPixelBuffer(SDL_Renderer * renderer, SDL_Texture * texture);
+void renderPixelBuffer(SDL_Renderer * renderer, SDL_Texture * texture, const BYTE (*pixels)[160][4]);
+
+// Renders an upscaled copy of the video buffer, width pixels wide
+void renderScaledBuffer(SDL_Renderer * renderer, SDL_Texture * texture, const BYTE * pixels, int width);
 
 // Renders a pixel at point <X, Y>
 void renderPixel(int x, int y, SDL_Renderer * renderer, pixel pixel);
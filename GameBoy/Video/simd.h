@@ -0,0 +1,11 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// SSE2 is used where the compiler targets it: always on x64, and on x86 with /arch:SSE2 or -msse2.
+// Every SIMD path has a plain C++ fallback producing the same results
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#endif /* simd.h */
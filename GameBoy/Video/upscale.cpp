@@ -0,0 +1,427 @@
+/*  Name:        upscale.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the pixel art upscaling filters that can be
+                 applied to finished frames before they are uploaded: integer
+                 nearest neighbor, Scale2x/Scale3x and a single pass xBR. Each
+                 frame is split into bands of rows across the worker pool. */
+
+#include "upscale.h"
+#include "simd.h"
+#include "worker_pool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Scales one source row of a frame into factor rows of output
+typedef void (*upscale_row)(const Uint32 * src, int y, Uint32 * out);
+
+// Name, scale factor and row function of each filter
+typedef struct upscale_filter_info
+{
+    const char * name;
+    int factor;
+    upscale_row row;
+} upscale_filter_info;
+
+// Define upscaler variables
+upscale_timing upscale_stats[UPSCALE_FILTER_COUNT];
+
+
+/* Function: static void PadRow(const Uint32 * src, int y, Uint32 padded[162])
+             Copies source row y, clamped to the frame, with its first and last
+             pixels repeated once on either side. */
+static inline void PadRow(const Uint32 * src, int y, Uint32 padded[162])
+{
+    y = (y < 0 ? 0 : (y > 143 ? 143 : y));
+    memcpy(&padded[1], &src[y * 160], 160 * sizeof(Uint32));
+    padded[0] = padded[1];
+    padded[161] = padded[160];
+}
+
+/* Function: static Uint32 SourcePixel(const Uint32 * src, int x, int y)
+             Returns a source pixel, clamping coordinates to the frame. */
+static inline Uint32 SourcePixel(const Uint32 * src, int x, int y)
+{
+    x = (x < 0 ? 0 : (x > 159 ? 159 : x));
+    y = (y < 0 ? 0 : (y > 143 ? 143 : y));
+    return src[y * 160 + x];
+}
+
+#ifdef USE_SSE2
+/* Function: static __m128i Select(__m128i mask, __m128i a, __m128i b)
+             Picks a where mask is set and b everywhere else. */
+static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i Load(const Uint32 * src)
+{
+    return _mm_loadu_si128((const __m128i *)src);
+}
+
+static inline void Store(Uint32 * dst, __m128i pixels)
+{
+    _mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+/* Function: static void Store3(Uint32 * dst, __m128i a, __m128i b, __m128i c)
+             Stores 4 pixels of each of a, b and c interleaved: a0 b0 c0 a1 ... c3. */
+static inline void Store3(Uint32 * dst, __m128i a, __m128i b, __m128i c)
+{
+    __m128i bc_lo = _mm_unpacklo_epi32(b, c);
+    __m128i bc_hi = _mm_unpackhi_epi32(b, c);
+
+    Store(&dst[0], _mm_unpacklo_epi64(_mm_unpacklo_epi32(a, b),
+                                      _mm_unpacklo_epi32(c, _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 2, 1, 1)))));
+    Store(&dst[4], _mm_unpacklo_epi64(_mm_unpackhi_epi64(bc_lo, bc_lo), _mm_unpackhi_epi32(a, b)));
+    Store(&dst[8], _mm_unpacklo_epi64(_mm_unpacklo_epi32(_mm_shuffle_epi32(c, _MM_SHUFFLE(3, 2, 1, 2)),
+                                                         _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 2, 1, 3))),
+                                      _mm_unpackhi_epi64(bc_hi, bc_hi)));
+}
+#endif
+
+/* Function: static void CopyRow(const Uint32 * src, int y, Uint32 * out)
+             No scaling. */
+static void CopyRow(const Uint32 * src, int y, Uint32 * out)
+{
+    memcpy(out, &src[y * 160], 160 * sizeof(Uint32));
+}
+
+/* Function: static void IntegerRow<factor>(const Uint32 * src, int y, Uint32 * out)
+             Nearest neighbor scaling: every pixel becomes a factor x factor block. */
+template <int factor>
+static void IntegerRow(const Uint32 * src, int y, Uint32 * out)
+{
+    const Uint32 * row = &src[y * 160];
+
+#ifdef USE_SSE2
+    for (int x = 0; x < 160; x += 4)
+    {
+        __m128i pixels = Load(&row[x]);
+        Uint32 * dst = &out[x * factor];
+
+        if (factor == 2)
+        {
+            Store(&dst[0], _mm_unpacklo_epi32(pixels, pixels));
+            Store(&dst[4], _mm_unpackhi_epi32(pixels, pixels));
+        }
+        else if (factor == 3)
+        {
+            Store3(dst, pixels, pixels, pixels);
+        }
+        else
+        {
+            Store(&dst[0],  _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 0, 0, 0)));
+            Store(&dst[4],  _mm_shuffle_epi32(pixels, _MM_SHUFFLE(1, 1, 1, 1)));
+            Store(&dst[8],  _mm_shuffle_epi32(pixels, _MM_SHUFFLE(2, 2, 2, 2)));
+            Store(&dst[12], _mm_shuffle_epi32(pixels, _MM_SHUFFLE(3, 3, 3, 3)));
+        }
+    }
+#else
+    for (int x = 0; x < 160; ++x)
+        for (int i = 0; i < factor; ++i)
+            out[x * factor + i] = row[x];
+#endif
+
+    // The remaining rows are the same as the first
+    for (int i = 1; i < factor; ++i)
+        memcpy(&out[i * 160 * factor], out, 160 * factor * sizeof(Uint32));
+}
+
+/* Function: static void Scale2xRow(const Uint32 * src, int y, Uint32 * out)
+             Scale2x. With B, D, F and H above, left, right and below pixel E,
+             a corner of E takes the color of its two neighbors when they match
+             each other and the edge does not continue past them:
+
+                 E0 = (D == B && B != F && D != H) ? D : E      E0 E1
+                 E1 = (B == F && B != D && F != H) ? F : E      E2 E3
+                 E2 = (D == H && D != B && H != F) ? D : E
+                 E3 = (H == F && D != H && B != F) ? F : E */
+static void Scale2xRow(const Uint32 * src, int y, Uint32 * out)
+{
+    Uint32 up[162];
+    Uint32 mid[162];
+    Uint32 down[162];
+    PadRow(src, y - 1, up);
+    PadRow(src, y, mid);
+    PadRow(src, y + 1, down);
+
+    Uint32 * out0 = out;
+    Uint32 * out1 = out + 320;
+
+#ifdef USE_SSE2
+    for (int x = 0; x < 160; x += 4)
+    {
+        __m128i B = Load(&up[x + 1]);
+        __m128i D = Load(&mid[x]);
+        __m128i E = Load(&mid[x + 1]);
+        __m128i F = Load(&mid[x + 2]);
+        __m128i H = Load(&down[x + 1]);
+
+        __m128i DB = _mm_cmpeq_epi32(D, B);
+        __m128i BF = _mm_cmpeq_epi32(B, F);
+        __m128i DH = _mm_cmpeq_epi32(D, H);
+        __m128i HF = _mm_cmpeq_epi32(H, F);
+
+        __m128i e0 = Select(_mm_andnot_si128(_mm_or_si128(BF, DH), DB), D, E);
+        __m128i e1 = Select(_mm_andnot_si128(_mm_or_si128(DB, HF), BF), F, E);
+        __m128i e2 = Select(_mm_andnot_si128(_mm_or_si128(DB, HF), DH), D, E);
+        __m128i e3 = Select(_mm_andnot_si128(_mm_or_si128(DH, BF), HF), F, E);
+
+        Store(&out0[x * 2],     _mm_unpacklo_epi32(e0, e1));
+        Store(&out0[x * 2 + 4], _mm_unpackhi_epi32(e0, e1));
+        Store(&out1[x * 2],     _mm_unpacklo_epi32(e2, e3));
+        Store(&out1[x * 2 + 4], _mm_unpackhi_epi32(e2, e3));
+    }
+#else
+    for (int x = 0; x < 160; ++x)
+    {
+        Uint32 B = up[x + 1];
+        Uint32 D = mid[x];
+        Uint32 E = mid[x + 1];
+        Uint32 F = mid[x + 2];
+        Uint32 H = down[x + 1];
+
+        out0[x * 2]     = (D == B && B != F && D != H) ? D : E;
+        out0[x * 2 + 1] = (B == F && B != D && F != H) ? F : E;
+        out1[x * 2]     = (D == H && D != B && H != F) ? D : E;
+        out1[x * 2 + 1] = (H == F && D != H && B != F) ? F : E;
+    }
+#endif
+}
+
+/* Function: static void Scale3xRow(const Uint32 * src, int y, Uint32 * out)
+             Scale3x. Corners follow the Scale2x rules; edge centers also need
+             the diagonal neighbors A, C, G and I so that only real edges, not
+             single pixels, are extended. The center always stays E. */
+static void Scale3xRow(const Uint32 * src, int y, Uint32 * out)
+{
+    Uint32 up[162];
+    Uint32 mid[162];
+    Uint32 down[162];
+    PadRow(src, y - 1, up);
+    PadRow(src, y, mid);
+    PadRow(src, y + 1, down);
+
+    Uint32 * out0 = out;
+    Uint32 * out1 = out + 480;
+    Uint32 * out2 = out + 960;
+
+#ifdef USE_SSE2
+    for (int x = 0; x < 160; x += 4)
+    {
+        __m128i A = Load(&up[x]);
+        __m128i B = Load(&up[x + 1]);
+        __m128i C = Load(&up[x + 2]);
+        __m128i D = Load(&mid[x]);
+        __m128i E = Load(&mid[x + 1]);
+        __m128i F = Load(&mid[x + 2]);
+        __m128i G = Load(&down[x]);
+        __m128i H = Load(&down[x + 1]);
+        __m128i I = Load(&down[x + 2]);
+
+        __m128i DB = _mm_cmpeq_epi32(D, B);
+        __m128i BF = _mm_cmpeq_epi32(B, F);
+        __m128i DH = _mm_cmpeq_epi32(D, H);
+        __m128i HF = _mm_cmpeq_epi32(H, F);
+        __m128i EA = _mm_cmpeq_epi32(E, A);
+        __m128i EC = _mm_cmpeq_epi32(E, C);
+        __m128i EG = _mm_cmpeq_epi32(E, G);
+        __m128i EI = _mm_cmpeq_epi32(E, I);
+
+        // Corner rules, as in Scale2x
+        __m128i c0 = _mm_andnot_si128(_mm_or_si128(BF, DH), DB);
+        __m128i c1 = _mm_andnot_si128(_mm_or_si128(DB, HF), BF);
+        __m128i c2 = _mm_andnot_si128(_mm_or_si128(DB, HF), DH);
+        __m128i c3 = _mm_andnot_si128(_mm_or_si128(DH, BF), HF);
+
+        __m128i e0 = Select(c0, D, E);
+        __m128i e1 = Select(_mm_or_si128(_mm_andnot_si128(EC, c0), _mm_andnot_si128(EA, c1)), B, E);
+        __m128i e2 = Select(c1, F, E);
+        __m128i e3 = Select(_mm_or_si128(_mm_andnot_si128(EG, c0), _mm_andnot_si128(EA, c2)), D, E);
+        __m128i e5 = Select(_mm_or_si128(_mm_andnot_si128(EI, c1), _mm_andnot_si128(EC, c3)), F, E);
+        __m128i e6 = Select(c2, D, E);
+        __m128i e7 = Select(_mm_or_si128(_mm_andnot_si128(EI, c2), _mm_andnot_si128(EG, c3)), H, E);
+        __m128i e8 = Select(c3, F, E);
+
+        Store3(&out0[x * 3], e0, e1, e2);
+        Store3(&out1[x * 3], e3, E, e5);
+        Store3(&out2[x * 3], e6, e7, e8);
+    }
+#else
+    for (int x = 0; x < 160; ++x)
+    {
+        Uint32 A = up[x];
+        Uint32 B = up[x + 1];
+        Uint32 C = up[x + 2];
+        Uint32 D = mid[x];
+        Uint32 E = mid[x + 1];
+        Uint32 F = mid[x + 2];
+        Uint32 G = down[x];
+        Uint32 H = down[x + 1];
+        Uint32 I = down[x + 2];
+
+        bool c0 = (D == B && B != F && D != H);
+        bool c1 = (B == F && B != D && F != H);
+        bool c2 = (D == H && D != B && H != F);
+        bool c3 = (H == F && D != H && B != F);
+
+        out0[x * 3]     = c0 ? D : E;
+        out0[x * 3 + 1] = ((c0 && E != C) || (c1 && E != A)) ? B : E;
+        out0[x * 3 + 2] = c1 ? F : E;
+        out1[x * 3]     = ((c0 && E != G) || (c2 && E != A)) ? D : E;
+        out1[x * 3 + 1] = E;
+        out1[x * 3 + 2] = ((c1 && E != I) || (c3 && E != C)) ? F : E;
+        out2[x * 3]     = c2 ? D : E;
+        out2[x * 3 + 1] = ((c2 && E != I) || (c3 && E != G)) ? H : E;
+        out2[x * 3 + 2] = c3 ? F : E;
+    }
+#endif
+}
+
+/* Function: static int ColorDistance(Uint32 a, Uint32 b)
+             Sum of the differences of each color channel. */
+static inline int ColorDistance(Uint32 a, Uint32 b)
+{
+    const BYTE * pa = (const BYTE *)&a;
+    const BYTE * pb = (const BYTE *)&b;
+    return abs(pa[1] - pb[1]) + abs(pa[2] - pb[2]) + abs(pa[3] - pb[3]);
+}
+
+/* Function: static Uint32 BlendHalf(Uint32 a, Uint32 b)
+             Rounded average of two colors, channel by channel. */
+static inline Uint32 BlendHalf(Uint32 a, Uint32 b)
+{
+    return (a | b) - (((a ^ b) & 0xFEFEFEFE) >> 1);
+}
+
+/* Function: static Uint32 XbrCorner(const Uint32 * src, int x, int y, int sx, int sy)
+             Returns the corner of pixel (x, y) facing (sx, sy). Laid out for
+             the bottom right corner (sx = sy = 1), the neighborhood is
+
+                    B                 An edge runs through the corner if the
+                 D  E  F  F4          pixels along the F-H diagonal are more
+                 G  H  I  I4          alike than those along E-I. The corner
+                    H5 I5             is then blended halfway towards whichever
+                                      of F and H is closer to E. */
+static inline Uint32 XbrCorner(const Uint32 * src, int x, int y, int sx, int sy)
+{
+    Uint32 E = SourcePixel(src, x, y);
+    Uint32 F = SourcePixel(src, x + sx, y);
+    Uint32 H = SourcePixel(src, x, y + sy);
+    if ((E == F) || (E == H))
+        return E;
+
+    Uint32 B  = SourcePixel(src, x, y - sy);
+    Uint32 C  = SourcePixel(src, x + sx, y - sy);
+    Uint32 D  = SourcePixel(src, x - sx, y);
+    Uint32 G  = SourcePixel(src, x - sx, y + sy);
+    Uint32 I  = SourcePixel(src, x + sx, y + sy);
+    Uint32 F4 = SourcePixel(src, x + 2 * sx, y);
+    Uint32 I4 = SourcePixel(src, x + 2 * sx, y + sy);
+    Uint32 H5 = SourcePixel(src, x, y + 2 * sy);
+    Uint32 I5 = SourcePixel(src, x + sx, y + 2 * sy);
+
+    int edge_weight = ColorDistance(E, C) + ColorDistance(E, G) + ColorDistance(I, F4) + ColorDistance(I, H5) + 4 * ColorDistance(H, F);
+    int across_weight = ColorDistance(H, D) + ColorDistance(H, I5) + ColorDistance(F, I4) + ColorDistance(F, B) + 4 * ColorDistance(E, I);
+    if (edge_weight >= across_weight)
+        return E;
+
+    return BlendHalf(E, (ColorDistance(E, F) <= ColorDistance(E, H)) ? F : H);
+}
+
+/* Function: static void Xbr2xRow(const Uint32 * src, int y, Uint32 * out)
+             Single pass, 2x xBR: each pixel's 4 corners are checked for edges
+             separately. */
+static void Xbr2xRow(const Uint32 * src, int y, Uint32 * out)
+{
+    for (int x = 0; x < 160; ++x)
+    {
+        out[x * 2]           = XbrCorner(src, x, y, -1, -1);
+        out[x * 2 + 1]       = XbrCorner(src, x, y,  1, -1);
+        out[320 + x * 2]     = XbrCorner(src, x, y, -1,  1);
+        out[320 + x * 2 + 1] = XbrCorner(src, x, y,  1,  1);
+    }
+}
+
+// Filters in upscale_filters order
+static const upscale_filter_info filter_info[UPSCALE_FILTER_COUNT] =
+{
+    { "none",    1, CopyRow },
+    { "int2",    2, IntegerRow<2> },
+    { "int3",    3, IntegerRow<3> },
+    { "int4",    4, IntegerRow<4> },
+    { "scale2x", 2, Scale2xRow },
+    { "scale3x", 3, Scale3xRow },
+    { "xbr2x",   2, Xbr2xRow }
+};
+
+/* Function: static void UpscaleBands(upscale_filters filter, const BYTE (*pixels)[160][4], BYTE * output)
+             Runs a filter over every row, UPSCALE_BAND_LINES rows per job. */
+static void UpscaleBands(upscale_filters filter, const BYTE (*pixels)[160][4], BYTE * output)
+{
+    const Uint32 * src = (const Uint32 *)pixels;
+    Uint32 * out = (Uint32 *)output;
+    const upscale_filter_info & info = filter_info[filter];
+    int row_size = 160 * info.factor * info.factor; // Output pixels per source row
+
+    ParallelFor((144 + UPSCALE_BAND_LINES - 1) / UPSCALE_BAND_LINES, [&](unsigned int band)
+    {
+        for (int y = band * UPSCALE_BAND_LINES; (y < (int)(band + 1) * UPSCALE_BAND_LINES) && (y < 144); ++y)
+            info.row(src, y, &out[y * row_size]);
+    });
+}
+
+upscale_filters GetUpscaleFilter(const char * name)
+{
+    for (int filter = 0; filter < UPSCALE_FILTER_COUNT; ++filter)
+    {
+        if (strcmp(name, filter_info[filter].name) == 0)
+            return (upscale_filters)filter;
+    }
+
+    return UPSCALE_FILTER_COUNT;
+}
+
+const char * GetUpscaleFilterName(upscale_filters filter)
+{
+    return filter_info[filter].name;
+}
+
+int GetUpscaleFactor(upscale_filters filter)
+{
+    return filter_info[filter].factor;
+}
+
+void UpscaleFrame(upscale_filters filter, const BYTE (*pixels)[160][4], BYTE * output)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    UpscaleBands(filter, pixels, output);
+
+    upscale_stats[filter].total_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    ++upscale_stats[filter].frames;
+}
+
+void BenchmarkUpscalers(const BYTE (*pixels)[160][4], unsigned int iterations)
+{
+    std::vector<BYTE> output(160 * 4 * 144 * 4 * 4);
+
+    printf("Upscaler timings over %u frames, %u threads:\n", iterations, GetWorkerCount());
+    for (int filter = UPSCALE_INTEGER2; filter < UPSCALE_FILTER_COUNT; ++filter)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < iterations; ++i)
+            UpscaleBands((upscale_filters)filter, pixels, &output[0]);
+        double total_us = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        int factor = filter_info[filter].factor;
+        printf("  %-8s %dx%d: %8.1f us/frame\n", filter_info[filter].name, 160 * factor, 144 * factor, total_us / iterations);
+    }
+}
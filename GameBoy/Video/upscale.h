@@ -0,0 +1,48 @@
+#ifndef UPSCALE_H
+#define UPSCALE_H
+
+#include "gameboy.h"
+
+// Source rows in each band of work handed to the worker pool
+#define UPSCALE_BAND_LINES   8
+
+// Upscaling filters applied to finished frames before they are uploaded
+typedef enum upscale_filters
+{
+    UPSCALE_NONE,        // Upload at 160x144 and leave scaling to the renderer
+    UPSCALE_INTEGER2,    // Nearest neighbor, 2x
+    UPSCALE_INTEGER3,    // Nearest neighbor, 3x
+    UPSCALE_INTEGER4,    // Nearest neighbor, 4x
+    UPSCALE_SCALE2X,     // Scale2x (EPX) edge smoothing, 2x
+    UPSCALE_SCALE3X,     // Scale3x edge smoothing, 3x
+    UPSCALE_XBR2X,       // Single pass xBR edge detection with 50% corner blending, 2x
+    UPSCALE_FILTER_COUNT
+} upscale_filters;
+
+// Time spent in a filter by UpscaleFrame
+typedef struct upscale_timing
+{
+    unsigned long long total_us;
+    unsigned int frames;
+} upscale_timing;
+
+/* Upscaler state (upscale.cpp) */
+extern upscale_timing upscale_stats[UPSCALE_FILTER_COUNT];
+
+// Returns the filter with the given name, or UPSCALE_FILTER_COUNT if there is none
+upscale_filters GetUpscaleFilter(const char * name);
+
+// Returns the name of a filter, as accepted by GetUpscaleFilter
+const char * GetUpscaleFilterName(upscale_filters filter);
+
+// Returns how many times wider and taller a filter's output is than its input
+int GetUpscaleFactor(upscale_filters filter);
+
+// Upscales a frame into output, which holds (160 * factor) x (144 * factor) pixels in pixel buffer format.
+// Bands of rows are split across the worker pool, if it has been started
+void UpscaleFrame(upscale_filters filter, const BYTE (*pixels)[160][4], BYTE * output);
+
+// Runs every filter on the given frame and prints the average time each took per frame
+void BenchmarkUpscalers(const BYTE (*pixels)[160][4], unsigned int iterations);
+
+#endif /* upscale.h */
@@ -0,0 +1,127 @@
+/*  Name:        video_sink.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the video sinks that finished frames are
+                 handed to: an SDL window, a memory buffer with a per-frame
+                 callback, and a sink that drops frames for headless runs. */
+
+#include "video_sink.h"
+#include "render.h"
+#include "color_convert.h"
+
+
+SDLVideoSink::SDLVideoSink(int width, int height, const char * title, upscale_filters filter) : filter(filter)
+{
+    int factor = GetUpscaleFactor(filter);
+    if (filter != UPSCALE_NONE)
+        scaled.resize(160 * factor * 144 * factor * 4);
+
+    SDL_InitSubSystem(SDL_INIT_VIDEO);
+    SDL_CreateWindowAndRenderer(width, height, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE, &window, &renderer);
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, 160 * factor, 144 * factor); // NOTE: RGBA format needs Alpha as first element, not last!
+
+    SDL_SetWindowTitle(window, title);
+
+    // Clear screen with White
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    SDL_RenderClear(renderer);
+}
+
+SDLVideoSink::~SDLVideoSink()
+{
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void SDLVideoSink::PresentFrame(const BYTE (*pixels)[160][4], bool changed)
+{
+    // Nothing new to upload or show
+    if (changed == false)
+        return;
+
+    if (filter == UPSCALE_NONE)
+    {
+        renderPixelBuffer(renderer, texture, pixels);
+    }
+    else
+    {
+        UpscaleFrame(filter, pixels, &scaled[0]);
+        renderScaledBuffer(renderer, texture, &scaled[0], 160 * GetUpscaleFactor(filter));
+    }
+
+    SDL_RenderCopy(renderer, texture, NULL, NULL);
+    SDL_RenderPresent(renderer);
+}
+
+void SDLVideoSink::PresentIndexedFrame(const BYTE (*shades)[160], bool changed)
+{
+    if (changed == false)
+        return;
+
+    ExpandIndexedFrame(shades, colors);
+    PresentFrame(colors, true);
+}
+
+MemoryVideoSink::MemoryVideoSink(frame_callback callback) : frame_count(0), callback(callback)
+{
+    memset(frame, 0, sizeof(frame));
+}
+
+void MemoryVideoSink::PresentFrame(const BYTE (*pixels)[160][4], bool changed)
+{
+    if (changed)
+        memcpy(frame, pixels, sizeof(frame));
+
+    if (callback)
+        callback(frame, frame_count);
+
+    ++frame_count;
+}
+
+void MemoryVideoSink::PresentIndexedFrame(const BYTE (*shades)[160], bool changed)
+{
+    if (changed)
+        ExpandIndexedFrame(shades, frame);
+
+    PresentFrame(frame, false);
+}
+
+IndexedMemoryVideoSink::IndexedMemoryVideoSink(bool packed, frame_callback callback) : packed(packed), frame_count(0), callback(callback)
+{
+    memset(frame, 0, sizeof(frame));
+    memset(packed_frame, 0, sizeof(packed_frame));
+}
+
+void IndexedMemoryVideoSink::PresentFrame(const BYTE (*pixels)[160][4], bool changed)
+{
+    if (changed)
+        ConvertFrameIndexed(pixels, frame[0]);
+
+    PassFrame(changed);
+}
+
+void IndexedMemoryVideoSink::PresentIndexedFrame(const BYTE (*shades)[160], bool changed)
+{
+    if (changed && (packed == false))
+        memcpy(frame, shades, sizeof(frame));
+
+    // Packed frames are packed straight out of the index buffer
+    if (changed && packed)
+        PackIndexedFrame(shades, packed_frame);
+
+    PassFrame(false);
+}
+
+void IndexedMemoryVideoSink::PassFrame(bool repack)
+{
+    if (repack && packed)
+        PackIndexedFrame(frame, packed_frame);
+
+    if (callback)
+        callback(GetFrame(), frame_count);
+
+    ++frame_count;
+}
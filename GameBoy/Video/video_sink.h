@@ -0,0 +1,104 @@
+#ifndef VIDEO_SINK_H
+#define VIDEO_SINK_H
+
+#include "gameboy.h"
+#include "upscale.h"
+#include "framebuffer.h"
+
+#include <functional>
+#include <vector>
+
+// Receives finished frames from the emulator. The main loop hands every frame
+// to exactly one sink, which decides what to do with it: show it in a window,
+// keep it in memory, or drop it.
+class VideoSink
+{
+public:
+    virtual ~VideoSink() {}
+
+    // Called once per frame. changed is false if the pixels are the same as in the previous call
+    virtual void PresentFrame(const BYTE (*pixels)[160][4], bool changed) = 0;
+
+    // Called instead of PresentFrame when the PPU draws into the index buffer.
+    // Sinks that need colors convert the shades here
+    virtual void PresentIndexedFrame(const BYTE (*shades)[160], bool changed) = 0;
+};
+
+// Shows frames in an SDL window. Only this sink initializes SDL video.
+// Frames are run through the given upscaling filter before they are uploaded
+class SDLVideoSink : public VideoSink
+{
+public:
+    SDLVideoSink(int width, int height, const char * title, upscale_filters filter = UPSCALE_NONE);
+    ~SDLVideoSink();
+
+    void PresentFrame(const BYTE (*pixels)[160][4], bool changed);
+    void PresentIndexedFrame(const BYTE (*shades)[160], bool changed);
+
+private:
+    SDL_Window * window;
+    SDL_Renderer * renderer;
+    SDL_Texture * texture;
+    upscale_filters filter;
+    std::vector<BYTE> scaled;  // Upscaled frame, when filtering
+    BYTE colors[144][160][4];  // Indexed frames converted to colors
+};
+
+// Drops every frame. Used to run without any display
+class NullVideoSink : public VideoSink
+{
+public:
+    void PresentFrame(const BYTE (*pixels)[160][4], bool changed) {}
+    void PresentIndexedFrame(const BYTE (*shades)[160], bool changed) {}
+};
+
+// Keeps a copy of the latest frame in memory and optionally passes each frame on to a callback
+class MemoryVideoSink : public VideoSink
+{
+public:
+    // Called with the latest frame and its number, counting from 0
+    typedef std::function<void(const BYTE (*pixels)[160][4], unsigned int frame)> frame_callback;
+
+    MemoryVideoSink(frame_callback callback = frame_callback());
+
+    void PresentFrame(const BYTE (*pixels)[160][4], bool changed);
+    void PresentIndexedFrame(const BYTE (*shades)[160], bool changed);
+
+    const BYTE (*GetFrame() const)[160][4] { return frame; }
+    unsigned int GetFrameCount() const { return frame_count; }
+
+private:
+    BYTE frame[144][160][4];
+    unsigned int frame_count;
+    frame_callback callback;
+};
+
+// Keeps a copy of the latest frame as shades, one byte per pixel or packed 4 pixels per byte
+// (leftmost pixel in the top 2 bits), and optionally passes each frame on to a callback.
+// Cheapest fed from the index buffer, where no colors are produced at all
+class IndexedMemoryVideoSink : public VideoSink
+{
+public:
+    // Called with the latest frame (160x144 or PACKED_FRAME_SIZE bytes) and its number, counting from 0
+    typedef std::function<void(const BYTE * shades, unsigned int frame)> frame_callback;
+
+    IndexedMemoryVideoSink(bool packed, frame_callback callback = frame_callback());
+
+    void PresentFrame(const BYTE (*pixels)[160][4], bool changed);
+    void PresentIndexedFrame(const BYTE (*shades)[160], bool changed);
+
+    const BYTE * GetFrame() const { return packed ? packed_frame : frame[0]; }
+    unsigned int GetFrameCount() const { return frame_count; }
+
+private:
+    // Packs frame if it changed and packed frames are kept, then counts the frame and calls the callback
+    void PassFrame(bool repack);
+
+    bool packed;
+    BYTE frame[144][160];
+    BYTE packed_frame[PACKED_FRAME_SIZE];
+    unsigned int frame_count;
+    frame_callback callback;
+};
+
+#endif /* video_sink.h */
@@ -0,0 +1,147 @@
+/*  Name:        worker_pool.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains a small fixed pool of worker threads used
+                 to split independent pieces of video work (scanlines, row
+                 bands) across the host's cores. */
+
+#include "worker_pool.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+// Define worker pool variables
+static std::vector<std::thread> pool_workers;                  // Worker threads, not counting the caller
+static std::mutex pool_mutex;
+static std::mutex pool_post_mutex;                             // Held while a job runs, so jobs posted by several emulator instances take turns
+static std::condition_variable pool_wakeup;                    // Signals workers that a new job was posted
+static std::condition_variable pool_done;                      // Signals the caller that all workers finished
+static const std::function<void(unsigned int)> * pool_job = NULL; // Current job
+static unsigned int pool_job_count = 0;                        // Number of indices in the current job
+static std::atomic<unsigned int> pool_next_index(0);           // Next index to be picked up
+static unsigned int pool_generation = 0;                       // Incremented for every posted job
+static unsigned int pool_finished = 0;                         // Workers done with the current job
+static bool pool_running = false;
+
+
+/* Function: static void RunJobs(const std::function<void(unsigned int)> & job, unsigned int count)
+             Picks up indices of the current job until none are left. */
+static void RunJobs(const std::function<void(unsigned int)> & job, unsigned int count)
+{
+    unsigned int index;
+    while ((index = pool_next_index.fetch_add(1)) < count)
+        job(index);
+}
+
+/* Function: static void WorkerMain()
+             Worker thread loop. Every worker takes part in every posted job
+             so that no worker can wander into the next one late. */
+static void WorkerMain()
+{
+    unsigned int seen_generation = 0;
+    std::unique_lock<std::mutex> lock(pool_mutex);
+
+    while (true)
+    {
+        pool_wakeup.wait(lock, [&seen_generation] { return (pool_running == false) ||
+                                                           (pool_generation != seen_generation); });
+        if (pool_running == false)
+            return;
+
+        seen_generation = pool_generation;
+        const std::function<void(unsigned int)> * job = pool_job;
+        unsigned int count = pool_job_count;
+
+        lock.unlock();
+        RunJobs(*job, count);
+        lock.lock();
+
+        if (++pool_finished == pool_workers.size())
+            pool_done.notify_one();
+    }
+}
+
+void StartWorkerPool(unsigned int threads)
+{
+    if (pool_running)
+        return;
+
+    if (threads == 0)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threads = (cores > 1 ? cores - 1 : 0);
+    }
+
+    // New workers start out at generation 0, so they must not see the last job of a previous pool as a new one
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_job = NULL;
+        pool_job_count = 0;
+        pool_generation = 0;
+        pool_finished = 0;
+        pool_running = true;
+    }
+
+    for (unsigned int i = 0; i < threads; ++i)
+        pool_workers.push_back(std::thread(WorkerMain));
+}
+
+void StopWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_running = false;
+    }
+    pool_wakeup.notify_all();
+
+    for (size_t i = 0; i < pool_workers.size(); ++i)
+        pool_workers[i].join();
+
+    pool_workers.clear();
+
+    // Nothing is left to pick up, and the next pool starts counting jobs from scratch
+    pool_job = NULL;
+    pool_job_count = 0;
+    pool_generation = 0;
+    pool_finished = 0;
+}
+
+unsigned int GetWorkerCount()
+{
+    return (unsigned int)pool_workers.size() + 1;
+}
+
+void ParallelFor(unsigned int count, const std::function<void(unsigned int)> & job)
+{
+    // Not worth waking anybody up
+    if (pool_workers.empty() || count <= 1)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            job(i);
+
+        return;
+    }
+
+    // The pool runs one job at a time. Another instance's job has to finish first
+    std::lock_guard<std::mutex> post_lock(pool_post_mutex);
+
+    // Post the job and work on it alongside the pool
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_job = &job;
+        pool_job_count = count;
+        pool_next_index.store(0);
+        pool_finished = 0;
+        ++pool_generation;
+    }
+    pool_wakeup.notify_all();
+
+    RunJobs(job, count);
+
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    pool_done.wait(lock, [] { return pool_finished == pool_workers.size(); });
+}
@@ -0,0 +1,19 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <functional>
+
+// Starts the pool with the given number of worker threads. 0 picks one less than the number of host cores
+void StartWorkerPool(unsigned int threads);
+
+// Stops and joins all worker threads
+void StopWorkerPool();
+
+// Returns the number of threads that take part in ParallelFor, including the caller
+unsigned int GetWorkerCount();
+
+// Runs job(0) ... job(count - 1) across the pool and the calling thread, returning once all are done.
+// Runs serially on the calling thread if the pool has not been started. Jobs from several threads run one at a time.
+void ParallelFor(unsigned int count, const std::function<void(unsigned int)> & job);
+
+#endif /* worker_pool.h */
@@ -0,0 +1,43 @@
+/*  Name:        context.cpp
+    Author:      Sergio Morales [sergiomorales.me]
+    Created:     October 19th, 2026
+    Modified:    October 19th, 2026
+    Description: This file contains the emulator instance, which holds the
+                 state of one emulated Game Boy that used to live in globals.
+                 Functions still take the CPU, and reach the rest of the
+                 instance through its back pointer. */
+
+#include "context.h"
+
+#include <cstring>
+
+GameBoy::GameBoy()
+{
+    CPU.gb = this;
+
+    // No cartridge is loaded yet
+    memset(&cart, 0, sizeof(cart));
+    memset(&mbc, 0, sizeof(mbc));
+
+    // The PPU runs from power on. InitPPU sets it up properly once the CPU is initialized
+    memset(&PPU, 0, sizeof(PPU));
+    memset(&fifo, 0, sizeof(fifo));
+    memset(&frame, 0, sizeof(frame));
+    PPU.lcd_enabled = true;
+    render_thread = NULL;
+    deferred = NULL;
+
+    ResetDirtyLines(dirty);
+    ResetFrameSkip(skip);
+
+    // No keys are held down
+    joypad.buttons = 0x0F;
+    joypad.dpad = 0x0F;
+}
+
+GameBoy::~GameBoy()
+{
+    // Scanlines still queued or logged are drawn before the renderers go away
+    StopRenderThread(CPU);
+    StopDeferredRender(CPU);
+}
@@ -0,0 +1,41 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "GBCPU.h"
+#include "GBCartridge.h"
+#include "mapper.h"
+#include "GBPPU.h"
+#include "pixel_fifo.h"
+#include "dirty_lines.h"
+#include "frame_skip.h"
+#include "joypad.h"
+#include "framebuffer.h"
+#include "render_thread.h"
+#include "deferred_render.h"
+
+/*
+	Class:		 GameBoy
+	Description: One emulated Game Boy: the CPU and everything else that changes as
+				 it runs. Nothing here is shared between instances, so several can run
+				 side by side, each on its own thread. Settings and host services
+				 (window, audio, recorder, frame capture) stay process-wide. */
+class GameBoy
+{
+public:
+    GBCPU CPU;                            // CPU, memory and page tables. CPU.gb points back at this instance
+    cartridge_info cart;                  // What the cartridge header says about the game
+    mapper_state mbc;                     // Bank registers of the cartridge's memory bank controller
+    ppu_state PPU;                        // Scanline engine state
+    pixel_fifo fifo;                      // Pixel FIFO engine state
+    dirty_line_state dirty;               // Unchanged scanline/frame tracking
+    frame_skip_state skip;                // Frame skip state
+    joypad_state joypad;                  // Keys currently held down
+    frame_buffer frame;                   // The screen the PPU draws into
+    render_thread_state * render_thread;  // Pipelined rendering, NULL while scanlines are drawn in place
+    deferred_render_state * deferred;     // Deferred rendering, NULL while scanlines are drawn in place
+
+    GameBoy();
+    ~GameBoy();
+};
+
+#endif /* context.h */
@@ -7,11 +7,29 @@
 
 #include <SDL.h>
 #include <Windows.h>
+#include <cerrno>
+#include <climits>
+#include <cctype>
 
 // Game Boy libraries
+#include "context.h"      // Per-instance emulator state
 #include "render.h"       // Graphics Rendering library
+#include "video_sink.h"   // Frame output (SDL window, memory, none)
+#include "recorder.h"     // Video recording
+#include "upscale.h"      // Pixel art upscaling filters
+#include "color_convert.h" // Frame color conversions
+#include "framebuffer.h"  // Indexed (shade per pixel) framebuffer
+#include "frame_capture.h" // Frame hashes and screenshots
+#include "worker_pool.h"  // Worker threads for video work
 #include "GBCartridge.h"  // ROM Cartridge library
+#include "save_ram.h"     // Battery-backed save RAM
+#include "mapper.h"       // Cartridge memory bank controllers
 #include "GBPPU.h"        // Game Boy PPU library
+#include "render_thread.h" // Pipelined PPU scanline rendering
+#include "deferred_render.h" // Deferred, parallel PPU frame rendering
+#include "dirty_lines.h"   // Unchanged scanline/frame skipping
+#include "frame_skip.h"    // Frame skipping
+#include "pixel_fifo.h"    // Dot-by-dot pixel FIFO PPU engine
 #include "joypad.h"       // SDL event/input processing
 #include "timers.h"       // CPU timer logic
 #include "interrupts.h"   // CPU interrupt logic
@@ -20,20 +38,34 @@
 // Top-level emulator configurations
 //#define DEBUG_GAMEBOY
 
+/* Function: static bool ParseCount(const char * option, const char * text, unsigned int & value)
+             Reads the number given to a command line option: whole, decimal
+             and 0 or more. Anything else is reported and leaves value as it
+             was. Returns false if the number was rejected. */
+static bool ParseCount(const char * option, const char * text, unsigned int & value)
+{
+    char * end = NULL;
+    errno = 0;
+    unsigned long number = strtoul(text, &end, 10);
+
+    // strtoul would take a sign or leading spaces, and wrap negative numbers around
+    if ((isdigit((unsigned char)text[0]) == 0) || (*end != '\0') || (errno == ERANGE) || (number > UINT_MAX))
+    {
+        printf("Invalid value for %s: %s. Expected a number of 0 or more\n", option, text);
+        return false;
+    }
+
+    value = (unsigned int)number;
+    return true;
+}
+
 int main(int argc, char **argv)
 {
-    // Initialize Simple DirectMedia Library for video rendering, audio, and keyboard events
-    SDL_Renderer *renderer;
-    SDL_Texture *texture;
-    SDL_Window *window;
-    
-    SDL_Init(SDL_INIT_EVERYTHING);
-    SDL_CreateWindowAndRenderer(160*3, 144*3, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE, &window, &renderer);
-    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, 160, 144); // NOTE: RGBA format needs Alpha as first element, not last!
+    // Initialize Simple DirectMedia Library for audio and keyboard events. Video is only brought up by the SDL video sink
+    SDL_Init(SDL_INIT_EVERYTHING & ~SDL_INIT_VIDEO);
 
-    // Clear screen with White
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-    SDL_RenderClear(renderer);
+    // Build the color conversion tables shared by every emulator instance
+    InitColorConversion();
 
     // Initialize audio
     SDL_GB_audio = { 0 };
@@ -49,17 +81,12 @@ int main(int argc, char **argv)
     // "09-op r,r.gb"
     //"Tetris (World).gb"
     string default_rom = "cpu_instrs.gb";
-    GBCPU CPU = GBCPU();
+    GameBoy * gb = new GameBoy();
+    GBCPU & CPU = gb->CPU;
 
     load_rom(argc < 2 ? default_rom : string(argv[1]), CPU);
     CPU.init();
-
-    // After loading ROM, set the window title to be the name of the game
-    //char window_name[40] = { "GameBoy Emulator: "  };
-    //strcat(window_name, rom_name);
-    //SDL_SetWindowTitle(window, window_name);
-    //SDL_SetWindowTitle(window, rom_name);
-    SDL_SetWindowTitle(window, "Gameboy Emulator");
+    InitPPU(CPU);
 
     // Capture Intro screen from ROM $104-133
     getIntroScreen(CPU);
@@ -76,11 +103,118 @@ int main(int argc, char **argv)
     // DEBUG: Max executions
     int counter_max = strtol((argc < 3 ? "200000" : argv[2]), NULL, 10);
 
+    // Optional emulator settings may follow the ROM name
+    bool headless = false;
+    unsigned int frames_to_run = 0; // 0 = run until the window is closed
+    upscale_filters upscale = UPSCALE_NONE;
+    bool upscale_benchmark = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        // Render scanlines on a dedicated thread instead of the CPU thread
+        if (string(argv[i]) == "--ppu-thread")
+            StartRenderThread(CPU);
+
+        // Log scanlines during the frame and render them across all cores at V-Blank
+        else if (string(argv[i]) == "--ppu-deferred")
+            StartDeferredRender(0, CPU);
+
+        // Render, upload and present every scanline of every frame, even if nothing changed
+        else if (string(argv[i]) == "--no-dirty-lines")
+            dirty_lines_enabled = false;
+
+        // Step the PPU dot by dot through its pixel FIFO instead of drawing whole scanlines
+        else if (string(argv[i]) == "--ppu-fifo")
+            SetPPUEngine(PPU_ENGINE_FIFO, CPU);
+
+        // Skip rendering N frames after each drawn frame, or "auto" to skip only while running behind
+        else if ((string(argv[i]) == "--frameskip") && (i + 1 < argc))
+        {
+            if (string(argv[++i]) == "auto")
+                frame_skip_adaptive = true;
+            else
+                ParseCount("--frameskip", argv[i], frame_skip);
+        }
+
+        // Draw shades into a byte per pixel framebuffer, leaving colors to the video sink
+        else if (string(argv[i]) == "--indexed")
+            framebuffer_format = FRAMEBUFFER_INDEXED;
+
+        // Run without a window
+        else if (string(argv[i]) == "--headless")
+            headless = true;
+
+        // Record every frame to a .y4m video, or to a raw stream of shades
+        else if ((string(argv[i]) == "--record") && (i + 1 < argc))
+            StartRecorder(argv[++i], RECORD_Y4M);
+        else if ((string(argv[i]) == "--record-indexed") && (i + 1 < argc))
+            StartRecorder(argv[++i], RECORD_INDEXED);
+        else if ((string(argv[i]) == "--record-packed") && (i + 1 < argc))
+            StartRecorder(argv[++i], RECORD_PACKED);
+
+        // Write the hash of every frame the PPU completes to a file
+        else if ((string(argv[i]) == "--frame-hashes") && (i + 1 < argc))
+            StartFrameHashLog(argv[++i]);
+
+        // Save a screenshot of frame N (counting frames completed by the PPU from 0) to a .png or .ppm
+        else if ((string(argv[i]) == "--screenshot") && (i + 2 < argc))
+        {
+            unsigned int frame;
+            if (ParseCount("--screenshot", argv[++i], frame))
+                RequestScreenshot(frame, argv[i + 1]);
+            ++i;
+        }
+
+        // Upscale frames on the CPU before they are uploaded to the window
+        else if ((string(argv[i]) == "--upscale") && (i + 1 < argc))
+        {
+            upscale = GetUpscaleFilter(argv[++i]);
+            if (upscale == UPSCALE_FILTER_COUNT)
+            {
+                printf("Unknown upscaling filter: %s\n", argv[i]);
+                upscale = UPSCALE_NONE;
+            }
+        }
+
+        // Time every upscaling filter on the last frame before quitting
+        else if (string(argv[i]) == "--upscale-benchmark")
+            upscale_benchmark = true;
+
+        // Quit after running the given number of frames
+        else if ((string(argv[i]) == "--frames") && (i + 1 < argc))
+            ParseCount("--frames", argv[++i], frames_to_run);
+
+        // Seconds of emulated time between writing save RAM out to disk, or 0 to only save when the game disables RAM
+        else if ((string(argv[i]) == "--save-interval") && (i + 1 < argc))
+            ParseCount("--save-interval", argv[++i], save_flush_interval);
+
+        // Run MBC3 real-time clocks on the host's wall time, so they keep counting while the emulator is closed
+        else if (string(argv[i]) == "--rtc-host")
+            SetRTCHostTime(true, CPU);
+    }
+
+    // Upscaling splits each frame across the worker pool
+    if ((upscale != UPSCALE_NONE) || upscale_benchmark)
+        StartWorkerPool(0);
+
+    // Frames go to a window unless running headless
+    VideoSink * video;
+    if (headless)
+        video = new NullVideoSink();
+    else
+        video = new SDLVideoSink(160 * 3, 144 * 3, "Gameboy Emulator", upscale);
+    unsigned int frames_run = 0;
+
     // Main execution loop
     while (1)
     {
-        // Update the screen with the pixel buffer. The FPS is assumed to be capped at 60 by SDL
-        renderPixelBuffer(renderer, texture);
+        // Wait for any pipelined scanlines to land in the pixel buffer before it is uploaded
+        FlushRenderThread(CPU);
+
+        // Hand the frame to the video sink, noting whether any scanline changed. The FPS is assumed to be capped at 60 by SDL
+        if (framebuffer_format == FRAMEBUFFER_INDEXED)
+            video->PresentIndexedFrame(gb->frame.index_buffer, IsFrameDirty(CPU));
+        else
+            video->PresentFrame(gb->frame.pixel_buffer, IsFrameDirty(CPU));
 
         // Execute the CPU and PPU by the number of clock cycles executed during this frame
         int cycles_in_frame = 0; // GAMEBOY_CYCLES_FRAME;
@@ -101,8 +235,9 @@ int main(int argc, char **argv)
             // Update DIV registers
             UpdateDIV(CPU.cycles, CPU);
 
-            // Execute the PPU based on the # of cycles the current instruction took
-            ExecutePPU(CPU.cycles, CPU);
+            // Execute the PPU based on the # of cycles the current instruction took. It is suspended while the LCD is off
+            if (gb->PPU.lcd_enabled)
+                ExecutePPU(CPU.cycles, CPU);
 
             // Check for any interrupts being requested if enabled
             CheckInterrupts(CPU);
@@ -115,21 +250,39 @@ int main(int argc, char **argv)
                 break;
         }
 
+        // Write save RAM out if the game has changed it for a while
+        UpdateSaveRAM(CPU);
+
         // Check again to quit outside of main game loop to avoid lag
-        if (quit)
+        if (quit || ((frames_to_run != 0) && (++frames_run >= frames_to_run)))
             break;
 
         //TestVideoRAM(CPU);
+    }
+
+    StopRenderThread(CPU);
+    StopDeferredRender(CPU);
+    StopRecorder();
+    StopFrameCapture();
+    unload_rom(CPU);
+
+    if (upscale_benchmark)
+    {
+        if (framebuffer_format == FRAMEBUFFER_INDEXED)
+            ExpandIndexedFrame(gb->frame.index_buffer, gb->frame.pixel_buffer);
 
-        // Render the screen
-        //SDL_RenderClear(renderer);
-        SDL_RenderCopy(renderer, texture, NULL, NULL);
-        SDL_RenderPresent(renderer);
+        BenchmarkUpscalers(gb->frame.pixel_buffer, 200);
     }
 
     std::cout << "Finished executing instructions..." << endl;
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    std::cout << "Scanlines rendered: " << gb->dirty.stats.lines_rendered << ", skipped: " << gb->dirty.stats.lines_skipped
+              << ". Frames presented: " << gb->dirty.stats.frames_presented << ", skipped: " << gb->dirty.stats.frames_skipped << endl;
+    if (upscale_stats[upscale].frames != 0)
+        std::cout << "Upscaling (" << GetUpscaleFilterName(upscale) << "): " << upscale_stats[upscale].frames << " frames, "
+                  << (upscale_stats[upscale].total_us / upscale_stats[upscale].frames) << " us per frame" << endl;
+    StopWorkerPool();
+    delete gb;
+    delete video;
     SDL_Quit();
     return EXIT_SUCCESS;
 }
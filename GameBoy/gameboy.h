@@ -2,7 +2,6 @@
 #define GAMEBOY_H
 
 #include <SDL.h>
-// @TODO: Make GBCPU instance a global, singleton (will allow for clean up of function params
 
 /********************************* Datatype Definitions *********************************/
 typedef unsigned char BYTE;
@@ -63,31 +62,6 @@ extern const Uint8 *SDL_GB_keyboard_state; // Holds the keys pressed
 extern SDL_Event SDL_GB_window_event;      // Current state of the SDL window session
 extern SDL_AudioSpec SDL_GB_audio;         // Holds the SDL audio configuration
 
-extern BYTE GB_buttons; // Packs the currently pressed button keys
-extern BYTE GB_dpad;    // Packs the currently pressed dpad keys
-
-/* Memory-related variables from extracting ROM (Cartridge.cpp) */
-extern BYTE * ext_rom;         // Holds all external (switchable) RAM, to be added in memory by 16 Kbyte banks
-extern BYTE * ext_ram;         // Holds all external (switchable) ROM, to be added in memory by 8 Kbyte banks
-extern size_t rom_size;        // Actual total ROM size in bytes
-extern size_t ram_size;        // Actual total RAM size in bytes
-extern size_t ext_rom_size;    // Size of external ROM in bytes
-extern size_t ext_ram_size;    // Size of external RAM in bytes
-extern MBC_TYPES rom_mbc_type; // The MBC cartridge type
-extern char rom_name[17];      // The 16-byte name specified in the cartridge from $134-143
-
-/* MBC management related variables (mbc.cpp) */
-extern memory_model_types memory_model; // The current maximum memory model for MBC
-extern BYTE current_rom_bank;           // The current switchable rom bank being used
-extern BYTE current_ram_bank;           // The current switchable ram bank beign used
-extern bool ram_bank_access_enabled;    // Indicates if RAM read/writes are enabled
-
-/* Video-rendering related variables (render.cpp) */
-extern BYTE pixel_buffer[144][160][4];
-
-/* PPU-related variables (GBPPU.cpp) */
-//extern unsigned short scanline_counter;
-
 
 
 
@@ -130,6 +104,9 @@ extern BYTE pixel_buffer[144][160][4];
 #define HRAM_END             0xFFFE  // High RAM ending address
 #define HRAM_START           0xFF80  // High RAM, otherwise known as Zero Page beginning address
 
+#define IO_END               0xFF7F  // I/O registers ending address
+#define IO_START             0xFF00  // I/O registers beginning address
+
 #define UNUSED_END           0xFEFF  // Unused memory region ending address
 #define UNUSED_START         0xFEA0  // Unused memory region beginning address
 
@@ -206,6 +183,7 @@ extern BYTE pixel_buffer[144][160][4];
 
 // LCD OAM DMA Transfers
 #define PPU_DMA             0xFF46 // DMA Transfer and Start Address
+#define DMA_CYCLES          640    // Length of a transfer (160 us), during which the CPU can only reach HRAM and IO
 
 
 // JOYPAD_P1 Bit Masks